@@ -0,0 +1,693 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/FileReader.h"
+#include "../src/Graph.h"
+#include "../src/Reorder.h"
+#include "../src/ThreadPool.h"
+#include "../src/TraversalWorkspace.h"
+
+/**
+ * Benchmarks for the Graph and FileReader. Build with `make bench`, then run `./bench` for all of
+ * them or `./bench <name>` for only the ones whose name contains <name>. An optional second
+ * argument sets the size of the synthetic inputs (`./bench parse 100000000` parses a 100M-Edge file).
+ * Times are wall clock, averaged over a few repetitions.
+ */
+
+using std::cout;
+using std::endl;
+
+/**
+ * @brief Size of the synthetic inputs, set from the command line
+ */
+size_t scale = 1000000;
+
+/**
+ * @brief Number of operator new calls so far, counted by the replacements below
+ */
+size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+/**
+ * @brief Number of allocations one run of fn makes
+ */
+template <typename Fn>
+size_t countAllocations(Fn fn) {
+    size_t before = allocations;
+    fn();
+    return allocations - before;
+}
+
+/**
+ * @brief Runs fn reps times and returns the average wall time of one run in microseconds
+ */
+template <typename Fn>
+double timeIt(Fn fn, int reps = 1) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) fn();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() / double(reps);
+}
+
+/**
+ * @brief Prints one result line
+ */
+void report(const string& what, double micros) {
+    cout << "  " << what << ": " << micros << " microseconds" << endl;
+}
+
+/**
+ * @brief Writes (once) a random SNAP-style edge list with num_edges Edges over num_edges / 16 Vertices
+ * 
+ * @return string Path of the file
+ */
+string syntheticEdgeFile(size_t num_edges) {
+    string path = "/tmp/bench_edges_" + std::to_string(num_edges) + ".txt";
+    if (std::ifstream(path).good())
+        return path;
+
+    std::ofstream out(path);
+    std::mt19937_64 rng(225);
+    std::uniform_int_distribution<uint64_t> vertex(0, std::max<size_t>(1, num_edges / 16));
+    out << "# Synthetic benchmark graph\n";
+    string line;
+    for (size_t i = 0; i < num_edges; ++i) {
+        line = std::to_string(vertex(rng));
+        line += ' ';
+        line += std::to_string(vertex(rng));
+        line += '\n';
+        out << line;
+    }
+    return path;
+}
+
+/****************************** Loading ******************************/
+
+void benchLoad() {
+    vector<string> lines;
+    report("FileReader::fileToVector (full dataset)", timeIt([&] { lines = FileReader::fileToVector("data/facebook_combined.txt"); }, 3));
+    report("Graph(lines, true) (full dataset)", timeIt([&] { Graph g(lines, true); }, 3));
+
+    vector<uint64_t> ids;
+    report("FileReader::fileToIds (full dataset)", timeIt([&] { ids = FileReader::fileToIds("data/facebook_combined.txt"); }, 3));
+    report("Graph(ids, true) (full dataset)", timeIt([&] { Graph g(ids, true); }, 3));
+
+    // What vertex registration alone used to cost: a std::find over the vertices seen so far, per endpoint
+    vector<Graph::Edge> edges;
+    for (size_t i = 0; i < lines.size() / 2; ++i) edges.emplace_back(lines[2 * i], lines[2 * i + 1]);
+    report("old std::find vertex registration (full dataset)", timeIt([&] {
+        vector<Vertex> vertices;
+        for (const Graph::Edge& e : edges) {
+            if (std::find(vertices.begin(), vertices.end(), e.start) == vertices.end()) vertices.push_back(e.start);
+            if (std::find(vertices.begin(), vertices.end(), e.end) == vertices.end()) vertices.push_back(e.end);
+        }
+    }));
+}
+
+void benchParse() {
+    report("FileReader::fileToVector (full dataset)", timeIt([] { FileReader::fileToVector("data/facebook_combined.txt"); }, 5));
+    report("FileReader::fileToIds (full dataset)", timeIt([] { FileReader::fileToIds("data/facebook_combined.txt"); }, 5));
+    for (unsigned t : {1u, 2u, 4u, 8u})
+        report("FileReader::fileToIdsParallel, " + std::to_string(t) + " threads (full dataset)",
+               timeIt([t] { FileReader::fileToIdsParallel("data/facebook_combined.txt", t); }, 5));
+
+    string path = syntheticEdgeFile(scale);
+    string what = " (" + std::to_string(scale) + " synthetic Edges)";
+    // 2 strings per Edge gets out of hand quickly
+    if (scale <= 10000000) report("FileReader::fileToVector" + what, timeIt([&] { FileReader::fileToVector(path); }));
+    report("FileReader::fileToIds" + what, timeIt([&] { FileReader::fileToIds(path); }));
+    for (unsigned t : {2u, 4u, 8u})
+        report("FileReader::fileToIdsParallel, " + std::to_string(t) + " threads" + what,
+               timeIt([&] { FileReader::fileToIdsParallel(path, t); }));
+}
+
+void benchSnapshot() {
+    Graph g(FileReader::fileToIds("data/facebook_combined.txt"), true);
+    string path = "/tmp/bench_facebook.snapshot";
+    report("Graph::saveSnapshot (full dataset)", timeIt([&] { g.saveSnapshot(path); }, 3));
+
+    report("text to queryable Graph: fileToIds + Graph(ids) (full dataset)", timeIt([] {
+        Graph loaded(FileReader::fileToIds("data/facebook_combined.txt"), true);
+        loaded.areConnected(0, 1);
+    }, 5));
+    report("snapshot to queryable Graph, checksum verified (full dataset)", timeIt([&] {
+        Graph loaded;
+        loaded.loadSnapshot(path);
+        loaded.areConnected(0, 1);
+    }, 5));
+    report("snapshot to queryable Graph, no checksum (full dataset)", timeIt([&] {
+        Graph loaded;
+        loaded.loadSnapshot(path, false);
+        loaded.areConnected(0, 1);
+    }, 5));
+
+    vector<uint64_t> ids = FileReader::fileToIds(syntheticEdgeFile(scale));
+    Graph big(ids, true);
+    big.saveSnapshot(path);
+    string what = " (" + std::to_string(scale) + " synthetic Edges)";
+    report("Graph(ids)" + what, timeIt([&] { Graph loaded(ids, true); }));
+    report("snapshot to queryable Graph, no checksum" + what, timeIt([&] {
+        Graph loaded;
+        loaded.loadSnapshot(path, false);
+        loaded.areConnected(0, 1);
+    }, 5));
+    std::remove(path.c_str());
+}
+
+/****************************** BFS scaling ******************************/
+
+/**
+ * @brief Flat id list of a connected random Graph on n Vertices: a ring, plus an Edge from every
+ * Vertex to a random one
+ */
+vector<uint64_t> ringGraphIds(size_t n) {
+    std::mt19937_64 rng(225);
+    vector<uint64_t> ids;
+    ids.reserve(4 * n);
+    for (size_t v = 0; v < n; ++v) {
+        ids.push_back(v);
+        ids.push_back((v + 1) % n);
+        ids.push_back(v);
+        ids.push_back(rng() % n);
+    }
+    return ids;
+}
+
+/**
+ * @brief BFS as it was before the head cursor: popping with queue.erase(queue.begin())
+ */
+vector<int> bfsErasing(const Graph& g, int start) {
+    vector<bool> visited(g.getSize(), false);
+    vector<int> queue, traversal;
+    queue.push_back(start);
+    visited[start] = true;
+    while (!queue.empty()) {
+        int vs = queue[0];
+        traversal.push_back(vs);
+        queue.erase(queue.begin());
+        for (Vertex i : g.neighbors(vs)) {
+            if (!visited[i]) {
+                queue.push_back(i);
+                visited[i] = true;
+            }
+        }
+    }
+    return traversal;
+}
+
+void benchBFSScaling() {
+    for (size_t n : {100000, 1000000, 10000000}) {
+        Graph g(ringGraphIds(n), true);
+        string what = " (" + std::to_string(n) + " Vertices, " + std::to_string(g.getEdgeCount()) + " stored Edges)";
+        double bfs = timeIt([&] { g.BFS(0, g); }, 3);
+        report("BFS" + what, bfs);
+        cout << "    " << 1000 * bfs / n << " nanoseconds per Vertex" << endl;
+        double search = timeIt([&] { g.Search_BFS(0, int(n / 2), g); }, 3);
+        report("Search_BFS to Vertex n / 2" + what, search);
+        // quadratic: only worth waiting for on the smallest one
+        if (n == 100000) report("BFS popping with erase(begin())" + what, timeIt([&] { bfsErasing(g, 0); }));
+    }
+}
+
+void benchDFS() {
+    for (size_t n : {1000000, 10000000}) {
+        Graph g(ringGraphIds(n), true);
+        string what = " (" + std::to_string(n) + " Vertices)";
+        vector<bool> visited;
+        vector<int> traversal;
+        report("DFS" + what, timeIt([&] {
+            visited.assign(n, false);
+            traversal.clear();
+            g.DFS(0, g, visited, traversal);
+        }, 3));
+        report("Search_DFS to Vertex n / 2" + what, timeIt([&] {
+            visited.assign(n, false);
+            traversal.clear();
+            g.Search_DFS(0, int(n / 2), g, visited, traversal);
+        }, 3));
+    }
+}
+
+/****************************** Direction-optimizing BFS ******************************/
+
+void benchDirectionOptimizing() {
+    size_t edges = std::min<size_t>(scale, 1000000);
+    for (int i = 0; i < 2; i++) {
+        string file = i == 0 ? "data/facebook_combined.txt" : syntheticEdgeFile(edges);
+        string what = i == 0 ? " (full dataset)" : " (" + std::to_string(edges) + " synthetic Edges)";
+        Graph g(FileReader::fileToIds(file), true);
+        vector<int> order = g.BFS(0, g);
+
+        report("BFS" + what, timeIt([&] { g.BFS(0, g); }, 5));
+        report("Search_BFS to the last Vertex reached" + what, timeIt([&] { g.Search_BFS(0, order.back(), g); }, 5));
+        report("directionOptimizingBFS, top-down only" + what, timeIt([&] { g.directionOptimizingBFS(0, 1e-9); }, 5));
+        report("directionOptimizingBFS, bottom-up only" + what, timeIt([&] { g.directionOptimizingBFS(0, 1e18, 1e18); }, 5));
+        report("directionOptimizingBFS" + what, timeIt([&] { g.directionOptimizingBFS(0); }, 5));
+        report("bidirectionalBFS to the last Vertex reached" + what, timeIt([&] { g.bidirectionalBFS(0, order.back()); }, 5));
+    }
+}
+
+/****************************** Parallel BFS ******************************/
+
+void benchParallelBFS() {
+    for (size_t n : {1000000, 10000000}) {
+        Graph g(ringGraphIds(n), true);
+        string what = " (" + std::to_string(n) + " Vertices)";
+        report("BFS" + what, timeIt([&] { g.BFS(0, g); }, 3));
+        for (unsigned threads : {1, 2, 4}) {
+            ThreadPool pool(threads);
+            vector<int> depth;
+            string on = ", " + std::to_string(threads) + " threads" + what;
+            report("parallelBFS" + on, timeIt([&] { g.parallelBFS(0, pool, depth); }, 3));
+            report("parallelBFS, deterministic" + on, timeIt([&] { g.parallelBFS(0, pool, depth, true); }, 3));
+        }
+    }
+}
+
+/****************************** Multi-source BFS ******************************/
+
+void benchMultiSourceBFS() {
+    size_t edges = std::min<size_t>(scale, 1000000);
+    for (int i = 0; i < 2; i++) {
+        string file = i == 0 ? "data/facebook_combined.txt" : syntheticEdgeFile(edges);
+        Graph g(FileReader::fileToIds(file), true);
+        vector<Vertex> sources;
+        for (Vertex v = 0; v < 256; ++v) sources.push_back(v * (g.getSize() / 256));
+        string what = " from 256 sources" + string(i == 0 ? " (full dataset)" : " (" + std::to_string(edges) + " synthetic Edges)");
+
+        report("BFS one source at a time" + what, timeIt([&] { for (Vertex s : sources) g.BFS(int(s), g); }));
+        report("directionOptimizingBFS one source at a time" + what, timeIt([&] { for (Vertex s : sources) g.directionOptimizingBFS(s); }));
+        report("multiSourceBFS" + what, timeIt([&] { g.multiSourceBFS(sources); }));
+        report("closeness" + what, timeIt([&] { g.closeness(sources); }));
+    }
+}
+
+/****************************** Memory-bounded IDDFS ******************************/
+
+void benchBoundedIddfs() {
+    Graph g(FileReader::fileToIds("data/facebook_combined.txt"), true);
+    vector<int> depth = g.directionOptimizingBFS(0);
+    for (int distance : {3, 4, 6}) {
+        Vertex target = Vertex(std::find(depth.begin(), depth.end(), distance) - depth.begin());
+        string what = " (full dataset, " + std::to_string(distance) + " Edges away)";
+        // exponential in the distance: only worth waiting for on the closest one
+        if (distance == 3) report("iddfs" + what, timeIt([&] { g.iddfs(0, int(target), 8); }));
+        if (distance <= 4) report("boundedIddfs without a table" + what, timeIt([&] { g.boundedIddfs(0, target, 8); }));
+        report("boundedIddfs with a 64 KB table" + what, timeIt([&] { g.boundedIddfs(0, target, 8, 1 << 16); }));
+        report("boundedIddfs with a 1 MB table" + what, timeIt([&] { g.boundedIddfs(0, target, 8, 1 << 20); }));
+        report("bidirectionalBFS" + what, timeIt([&] { g.bidirectionalBFS(0, target); }));
+    }
+}
+
+void benchParallelIddfs() {
+    Graph g(FileReader::fileToIds("data/facebook_combined.txt"), true);
+    vector<int> depth = g.directionOptimizingBFS(0);
+    for (int distance : {3, 4}) {
+        int target = int(std::find(depth.begin(), depth.end(), distance) - depth.begin());
+        string what = " (full dataset, " + std::to_string(distance) + " Edges away)";
+        if (distance == 3) report("iddfs" + what, timeIt([&] { g.iddfs(0, target, 8); }));
+        for (unsigned threads : {1, 2, 4}) {
+            ThreadPool pool(threads);
+            report("parallelIddfs, " + std::to_string(threads) + " threads" + what, timeIt([&] { g.parallelIddfs(0, target, 8, pool); }));
+        }
+    }
+}
+
+/****************************** Traversal workspace ******************************/
+
+void benchWorkspace() {
+    size_t n = scale;
+    Graph g(ringGraphIds(n), true);
+    string what = " (" + std::to_string(n) + " Vertices, 10000 queries)";
+    std::mt19937_64 rng(7);
+    vector<Vertex> starts;
+    for (int i = 0; i < 10000; ++i) starts.push_back(rng() % n);
+
+    // targets one hop away: each query explores a handful of Vertices
+    report("Search_BFS to a neighbor" + what, timeIt([&] {
+        for (Vertex s : starts) g.Search_BFS(int(s), int(g.neighbors(s)[0]), g);
+    }));
+    TraversalWorkspace ws, backward;
+    report("Search_BFS to a neighbor, with a workspace" + what, timeIt([&] {
+        for (Vertex s : starts) g.Search_BFS(s, g.neighbors(s)[0], ws);
+    }));
+    report("bidirectionalBFS to a neighbor" + what, timeIt([&] {
+        for (Vertex s : starts) g.bidirectionalBFS(s, g.neighbors(s)[0]);
+    }));
+    report("bidirectionalBFS to a neighbor, with workspaces" + what, timeIt([&] {
+        for (Vertex s : starts) g.bidirectionalBFS(s, g.neighbors(s)[0], ws, backward);
+    }));
+}
+
+/****************************** Lazy traversal ranges ******************************/
+
+void benchRanges() {
+    for (size_t n : {1000000, 10000000}) {
+        Graph g(ringGraphIds(n), true);
+        string what = " (" + std::to_string(n) + " Vertices)";
+        TraversalWorkspace ws(n);
+        size_t sum = 0;
+        report("BFS, then the first 10" + what, timeIt([&] {
+            vector<int> order = g.BFS(Vertex(0), ws);
+            for (int i = 0; i < 10; ++i) sum += order[i];
+        }, 3));
+        report("bfsRange, first 10" + what, timeIt([&] {
+            int taken = 0;
+            for (const TraversalStep& step : g.bfsRange(0, ws)) {
+                sum += step.vertex;
+                if (++taken == 10) break;
+            }
+        }, 3));
+        report("bfsRange, all of it" + what, timeIt([&] {
+            for (const TraversalStep& step : g.bfsRange(0, ws)) sum += step.vertex;
+        }, 3));
+        report("DFS, then the first 10" + what, timeIt([&] {
+            vector<int> order = g.DFS(Vertex(0), ws);
+            for (int i = 0; i < 10; ++i) sum += order[i];
+        }, 3));
+        report("dfsRange, first 10" + what, timeIt([&] {
+            int taken = 0;
+            for (const TraversalStep& step : g.dfsRange(0, ws)) {
+                sum += step.vertex;
+                if (++taken == 10) break;
+            }
+        }, 3));
+        report("dfsRange, all of it" + what, timeIt([&] {
+            for (const TraversalStep& step : g.dfsRange(0, ws)) sum += step.vertex;
+        }, 3));
+        // keeps the sums from being optimized away
+        if (sum == 42) cout << endl;
+    }
+}
+
+/****************************** k-hop neighborhoods ******************************/
+
+void benchKHop() {
+    Graph g(FileReader::fileToIds("data/facebook_combined.txt"), true);
+    vector<Vertex> sources;
+    for (Vertex v = 0; v < g.getSize(); ++v) sources.push_back(v);
+    string what = " (full dataset, all " + std::to_string(sources.size()) + " Vertices)";
+    TraversalWorkspace ws;
+    auto per_second = [&sources](double micros) {
+        cout << "    " << size_t(sources.size() * 1e6 / micros) << " queries per second" << endl;
+    };
+
+    double bfs = timeIt([&] { for (Vertex s : sources) g.BFS(int(s), g); });
+    report("BFS from each" + what, bfs);
+    per_second(bfs);
+    for (int k : {2, 3}) {
+        string hops = ", k = " + std::to_string(k) + what;
+        double groups = timeIt([&] { g.kHopNeighborhood(sources, k, ws); });
+        report("kHopNeighborhood" + hops, groups);
+        per_second(groups);
+        double counts = timeIt([&] { g.kHopCounts(sources, k, ws); });
+        report("kHopCounts" + hops, counts);
+        per_second(counts);
+    }
+}
+
+/****************************** Shortest-path trees ******************************/
+
+void benchShortestPathTree() {
+    Graph g(FileReader::fileToIds("data/facebook_combined.txt"), true);
+    vector<Vertex> targets;
+    for (Vertex v = 0; v < g.getSize(); v += 4) targets.push_back(v);
+    string what = " (full dataset, " + std::to_string(targets.size()) + " paths from Vertex 0)";
+    TraversalWorkspace ws, backward;
+    size_t length = 0;
+
+    report("Search_BFS for each" + what, timeIt([&] {
+        for (Vertex t : targets) length += g.Search_BFS(0, t, ws).size();
+    }));
+    report("bidirectionalBFS for each" + what, timeIt([&] {
+        for (Vertex t : targets) length += g.bidirectionalBFS(0, t, ws, backward).size();
+    }));
+    report("shortestPathTree once, then pathTo" + what, timeIt([&] {
+        ShortestPathTree tree = g.shortestPathTree(0, ws);
+        for (Vertex t : targets) length += tree.pathTo(t).size();
+    }));
+    ShortestPathCache<Graph> cache(g, 4);
+    cache.tree(0);
+    report("ShortestPathCache::path, tree cached" + what, timeIt([&] {
+        for (Vertex t : targets) length += cache.path(0, t).size();
+    }));
+    // keeps the paths from being optimized away
+    if (length == 42) cout << endl;
+}
+
+/****************************** Weighted shortest paths ******************************/
+
+/**
+ * @brief dijkstra with std::priority_queue, a binary heap of (distance, Vertex) pairs, as a baseline
+ */
+vector<double> dijkstraBinaryHeap(const Graph& g, Vertex source) {
+    typedef std::pair<double, Vertex> Entry;
+    vector<double> dist(g.getSize(), ShortestPathTree::infinity());
+    std::priority_queue<Entry, vector<Entry>, std::greater<Entry>> heap;
+    dist[source] = 0;
+    heap.push(Entry(0, source));
+    while (!heap.empty()) {
+        Entry top = heap.top();
+        heap.pop();
+        if (top.first != dist[top.second]) continue;
+        Graph::Neighbors adj = g.neighbors(top.second);
+        for (size_t i = 0; i < adj.size(); ++i) {
+            double d = top.first + adj.weight(i);
+            if (d < dist[adj[i]]) {
+                dist[adj[i]] = d;
+                heap.push(Entry(d, adj[i]));
+            }
+        }
+    }
+    return dist;
+}
+
+void benchShortestPaths() {
+    size_t edges = std::min<size_t>(scale, 1000000);
+    for (int i = 0; i < 2; i++) {
+        vector<uint64_t> ids = FileReader::fileToIds(i == 0 ? "data/facebook_combined.txt" : syntheticEdgeFile(edges));
+        vector<Graph::Edge> weighted;
+        size_t n = 0;
+        for (size_t k = 0; k + 1 < ids.size(); k += 2) {
+            weighted.emplace_back(ids[k], ids[k + 1], double(1 + (ids[k] * 31 + ids[k + 1] * 17) % 100));
+            n = std::max<size_t>(n, std::max(ids[k], ids[k + 1]) + 1);
+        }
+        Graph g(weighted, n, true);
+        string what = i == 0 ? " (full dataset, weights 1..100)" : " (" + std::to_string(edges) + " synthetic Edges, weights 1..100)";
+
+        report("Dijkstra, binary heap" + what, timeIt([&] { dijkstraBinaryHeap(g, 0); }, 3));
+        report("dijkstra, 4-ary heap" + what, timeIt([&] { g.dijkstra(0); }, 3));
+        for (unsigned threads : {1, 2, 4}) {
+            ThreadPool pool(threads);
+            report("deltaStepping, " + std::to_string(threads) + " threads" + what, timeIt([&] { g.deltaStepping(0, pool); }, 3));
+        }
+    }
+}
+
+/****************************** Neighbor access ******************************/
+
+/**
+ * @brief dls as it was before Graph::neighbors(): a fresh vector<Edge> at every level
+ */
+bool dlsCopying(const Graph& g, int start, int end, int limit, vector<int>& path) {
+    if (start == end) {
+        path.push_back(start);
+        return true;
+    }
+    if (limit <= 0) return false;
+    vector<Graph::Edge> adj = g.getOutgoingEdges(start);
+    for (unsigned i = 0; i < adj.size(); i++) {
+        if (dlsCopying(g, adj[i].end, end, limit - 1, path)) {
+            path.push_back(start);
+            return true;
+        }
+    }
+    return false;
+}
+
+void benchNeighbors() {
+    Graph g(FileReader::fileToIds("data/facebook_combined.txt"), true);
+    size_t sum = 0;
+
+    auto copying = [&] {
+        for (Vertex v = 0; v < g.getSize(); ++v)
+            for (const Graph::Edge& e : g.getOutgoingEdges(v)) sum += e.end;
+    };
+    auto viewing = [&] {
+        for (Vertex v = 0; v < g.getSize(); ++v)
+            for (Vertex u : g.neighbors(v)) sum += u;
+    };
+    cout << "  getOutgoingEdges of every Vertex: " << countAllocations(copying) << " allocations" << endl;
+    report("getOutgoingEdges of every Vertex (full dataset)", timeIt(copying, 20));
+    cout << "  neighbors of every Vertex: " << countAllocations(viewing) << " allocations" << endl;
+    report("neighbors of every Vertex (full dataset)", timeIt(viewing, 20));
+
+    // IDDFS from 0 to a Vertex 3 hops away, so dls runs all of its levels
+    vector<int> order = g.BFS(0, g);
+    int target = 0;
+    for (int v : order) {
+        if (g.iddfs(0, v, 4).size() == 4) { target = v; break; }
+    }
+    vector<int> path;
+    auto old_iddfs = [&] {
+        for (int limit = 1; limit < 4; limit++) {
+            path.clear();
+            if (dlsCopying(g, 0, target, limit, path)) break;
+        }
+    };
+    auto new_iddfs = [&] {
+        for (int limit = 1; limit < 4; limit++) {
+            path.clear();
+            if (g.dls(0, target, limit, path)) break;
+        }
+    };
+    path.reserve(8);
+    string what = " to a Vertex 3 hops away (full dataset)";
+    cout << "  dls with getOutgoingEdges" << what << ": " << countAllocations(old_iddfs) << " allocations" << endl;
+    report("dls with getOutgoingEdges" + what, timeIt(old_iddfs, 3));
+    cout << "  dls with neighbors" << what << ": " << countAllocations(new_iddfs) << " allocations" << endl;
+    report("dls with neighbors" + what, timeIt(new_iddfs, 3));
+
+    // What is left are the result, queue and visited vectors, growing geometrically
+    vector<bool> visited(g.getSize(), false);
+    vector<int> traversal;
+    cout << "  BFS: " << countAllocations([&] { g.BFS(0, g); }) << " allocations" << endl;
+    cout << "  Search_BFS: " << countAllocations([&] { g.Search_BFS(0, target, g); }) << " allocations" << endl;
+    cout << "  DFS: " << countAllocations([&] { g.DFS(0, g, visited, traversal); }) << " allocations" << endl;
+    if (sum == 42) cout << "";
+}
+
+/****************************** Specialized Graph types ******************************/
+
+/**
+ * @brief Times the read-only kernels of one BasicGraph type, built from ids
+ */
+template <typename G>
+void benchGraphType(const string& type, const vector<uint64_t>& ids, const string& what) {
+    G g(ids, true);
+    cout << "  " << type << what << ": " << g.memoryBytes() << " bytes of CSR arrays" << endl;
+    report(type + ": full BFS" + what, timeIt([&] { g.BFS(0, g); }, 5));
+    report(type + ": countTriangles" + what, timeIt([&] { g.countTriangles(); }, 3));
+
+    size_t sum = 0;
+    report(type + ": getInDegree of every Vertex" + what, timeIt([&] {
+        for (Vertex v = 0; v < g.getSize(); ++v) sum += g.getInDegree(v);
+    }, 20));
+    report(type + ": getWeight of every Edge" + what, timeIt([&] {
+        double total = 0;
+        for (size_t i = 0; i + 1 < ids.size(); i += 2) total += g.getWeight(ids[i], ids[i + 1]);
+        sum += size_t(total);
+    }, 5));
+    if (sum == 42) cout << "";
+}
+
+void benchTemplate() {
+    vector<uint64_t> fb = FileReader::fileToIds("data/facebook_combined.txt");
+    size_t edges = std::min<size_t>(scale, 1000000);
+    vector<uint64_t> synthetic = FileReader::fileToIds(syntheticEdgeFile(edges));
+    for (int i = 0; i < 2; i++) {
+        const vector<uint64_t>& ids = i == 0 ? fb : synthetic;
+        string what = i == 0 ? " (full dataset)" : " (" + std::to_string(edges) + " synthetic Edges)";
+        benchGraphType<Graph>("Graph", ids, what);
+        benchGraphType<BasicGraph<bool, Undirected>>("BasicGraph<bool, Undirected>", ids, what);
+        benchGraphType<BasicGraph<float, Directed>>("BasicGraph<float, Directed>", ids, what);
+    }
+}
+
+/****************************** Reordering ******************************/
+
+/**
+ * @brief Times BFS, FloydWarshall and triangle counting on g under every ordering, the original one first
+ *
+ * @param fw_ok False if g is too big for the O(n^3) FloydWarshall
+ */
+void benchOrderings(const Graph& g, const string& what, bool fw_ok) {
+    const char* names[] = {"original", "degree", "RCM", "Gorder"};
+    for (int method = 0; method < 4; method++) {
+        Graph h = g;
+        vector<Vertex> new_id;
+        double order_time = timeIt([&] {
+            if (method == 1) new_id = Reorder::byDegree(g);
+            else if (method == 2) new_id = Reorder::reverseCuthillMcKee(g);
+            else if (method == 3) new_id = Reorder::gorder(g);
+        });
+        if (method > 0) {
+            order_time += timeIt([&] { h.reorder(new_id); });
+            report(string(names[method]) + ": ordering + Graph::reorder" + what, order_time);
+        }
+
+        // same source Vertex every time, wherever it ended up
+        int source = method > 0 ? int(new_id[0]) : 0;
+        report(string(names[method]) + ": full BFS" + what, timeIt([&] { h.BFS(source, h); }, 5));
+        report(string(names[method]) + ": countTriangles" + what, timeIt([&] { h.countTriangles(); }, 3));
+        if (fw_ok) report(string(names[method]) + ": FloydWarshall" + what, timeIt([&] { h.FloydWarshall(); }));
+    }
+}
+
+void benchReorder() {
+    benchOrderings(Graph(FileReader::fileToIds("data/facebook_combined.txt"), true), " (full dataset)", false);
+
+    // FloydWarshall is O(n^3), so it only gets a small Graph
+    benchOrderings(Graph(FileReader::fileToIds(syntheticEdgeFile(16000)), true), " (16000 synthetic Edges)", true);
+
+    // Gorder takes a few seconds per million Edges, so cap the big Graph there
+    size_t edges = std::min<size_t>(scale, 1000000);
+    benchOrderings(Graph(FileReader::fileToIds(syntheticEdgeFile(edges)), true), " (" + std::to_string(edges) + " synthetic Edges)", false);
+}
+
+/****************************** Driver ******************************/
+
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+int main(int argc, char** argv) {
+    Benchmark benchmarks[] = {
+        {"load", benchLoad},
+        {"parse", benchParse},
+        {"snapshot", benchSnapshot},
+        {"reorder", benchReorder},
+        {"template", benchTemplate},
+        {"neighbors", benchNeighbors},
+        {"dobfs", benchDirectionOptimizing},
+        {"bfsscale", benchBFSScaling},
+        {"pbfs", benchParallelBFS},
+        {"dfs", benchDFS},
+        {"iddfs", benchBoundedIddfs},
+        {"piddfs", benchParallelIddfs},
+        {"workspace", benchWorkspace},
+        {"ranges", benchRanges},
+        {"khop", benchKHop},
+        {"sptree", benchShortestPathTree},
+        {"sssp", benchShortestPaths},
+        {"msbfs", benchMultiSourceBFS},
+    };
+    if (argc > 2) scale = std::strtoull(argv[2], nullptr, 10);
+
+    for (const Benchmark& b : benchmarks) {
+        if (argc > 1 && !std::strstr(b.name, argv[1])) continue;
+        cout << "[" << b.name << "]" << endl;
+        b.run();
+    }
+    return 0;
+}
@@ -5,7 +5,7 @@
 #include "src/FileReader.h"
 
 int main() {   
-    vector<string> lines;    
+    string dataset;
     start:
         int graph_file = -1, double_dir = -1, full_subset;
         bool is_full_dataset;
@@ -49,9 +49,9 @@ int main() {
         }
         
         // Deciding between simple and complex graph (ONLY if subset was picked)
-        if (!is_full_dataset && graph_file == 1) lines = FileReader::fileToVector("data/simple_graph.txt"); // Simple
-        else if (!is_full_dataset && graph_file == 2) lines = FileReader::fileToVector("data/complex_graph.txt"); // Complex
-        else if (is_full_dataset) lines = FileReader::fileToVector("data/facebook_combined.txt"); // Full Dataset
+        if (!is_full_dataset && graph_file == 1) dataset = "data/simple_graph.txt"; // Simple
+        else if (!is_full_dataset && graph_file == 2) dataset = "data/complex_graph.txt"; // Complex
+        else if (is_full_dataset) dataset = "data/facebook_combined.txt"; // Full Dataset
         else {
             cout << "Sorry, that command is not recognized. Try Again." << endl;
             graph_file = -1;
@@ -81,6 +81,15 @@ int main() {
         }
 
     bool double_directed = double_dir - 1;
-    Graph g(lines, double_directed);
+
+    // Reuse the binary snapshot from a previous run if the text has not changed since, otherwise parse the text and save one
+    string snapshot = dataset + (double_directed ? ".double" : ".single") + ".snapshot";
+    Graph g;
+    if (!g.loadSnapshot(snapshot, true, dataset)) {
+        // The menus show and take the ids exactly as they are in the file, so they are not compacted: our datasets
+        // are already dense. A tool for sparse ids would compact them with an IdMap and translate its own I/O.
+        g = Graph(FileReader::fileToIdsParallel(dataset), double_directed);
+        g.saveSnapshot(snapshot, dataset);
+    }
     g.start_presentation(is_full_dataset);
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "BitMatrix.h"
+
+BitMatrix::BitMatrix(size_t n) : n_(n), words_per_row_((n + 63) / 64), bits_(n * ((n + 63) / 64), 0) {}
+
+size_t BitMatrix::rowCount(size_t r) const {
+    const uint64_t* bits = row(r);
+    size_t count = 0;
+    for (size_t i = 0; i < words_per_row_; ++i) count += __builtin_popcountll(bits[i]);
+    return count;
+}
+
+vector<size_t> BitMatrix::neighbors(size_t r) const {
+    vector<size_t> out;
+    out.reserve(rowCount(r));
+
+    const uint64_t* bits = row(r);
+    for (size_t i = 0; i < words_per_row_; ++i) {
+        // peel off the lowest set bit until the word is empty
+        for (uint64_t w = bits[i]; w; w &= w - 1) out.push_back((i << 6) + __builtin_ctzll(w));
+    }
+    return out;
+}
+
+size_t BitMatrix::countCommon(size_t a, size_t b) const {
+    const uint64_t* row_a = row(a);
+    const uint64_t* row_b = row(b);
+    size_t count = 0;
+    for (size_t i = 0; i < words_per_row_; ++i) count += __builtin_popcountll(row_a[i] & row_b[i]);
+    return count;
+}
+
+void BitMatrix::expandFrontier(const vector<uint64_t>& frontier, vector<uint64_t>& visited, vector<uint64_t>& next) const {
+    next.assign(words_per_row_, 0);
+
+    // OR together the rows of every frontier vertex
+    for (size_t i = 0; i < words_per_row_; ++i) {
+        for (uint64_t w = frontier[i]; w; w &= w - 1) {
+            const uint64_t* bits = row((i << 6) + __builtin_ctzll(w));
+            for (size_t j = 0; j < words_per_row_; ++j) next[j] |= bits[j];
+        }
+    }
+
+    // then drop everything already seen
+    for (size_t j = 0; j < words_per_row_; ++j) {
+        next[j] &= ~visited[j];
+        visited[j] |= next[j];
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+/**
+ * A dense n x n adjacency matrix storing one bit per cell. Used by Graph as an optional
+ * index for unweighted graphs, where it is 64x smaller than a matrix of doubles and
+ * lets whole rows be combined a word (64 vertices) at a time.
+ */
+class BitMatrix {
+    public:
+        /**
+         * @brief Construct an empty 0 x 0 BitMatrix
+         */
+        BitMatrix() : n_(0), words_per_row_(0) {}
+
+        /**
+         * @brief Construct an n x n BitMatrix with every bit cleared
+         *
+         * @param n Number of rows (and columns)
+         */
+        explicit BitMatrix(size_t n);
+
+        /**
+         * @brief Number of rows (and columns) in the matrix
+         */
+        inline size_t size() const { return n_; }
+
+        /**
+         * @brief Number of 64-bit words that make up each row
+         */
+        inline size_t wordsPerRow() const { return words_per_row_; }
+
+        /**
+         * @brief Bytes used to store the bits
+         */
+        inline size_t memoryBytes() const { return bits_.size() * sizeof(uint64_t); }
+
+        /**
+         * @brief Pointer to the first word of a row. Bit (c % 64) of word (c / 64) is cell (r, c).
+         *
+         * @param r Row to get
+         * @return const uint64_t* Start of the row, wordsPerRow() words long
+         */
+        inline const uint64_t* row(size_t r) const { return bits_.data() + r * words_per_row_; }
+
+        /**
+         * @brief Checks cell (r, c)
+         */
+        inline bool test(size_t r, size_t c) const { return (row(r)[c >> 6] >> (c & 63)) & 1; }
+
+        /**
+         * @brief Sets cell (r, c)
+         */
+        inline void set(size_t r, size_t c) { bits_[r * words_per_row_ + (c >> 6)] |= uint64_t(1) << (c & 63); }
+
+        /**
+         * @brief Clears cell (r, c)
+         */
+        inline void reset(size_t r, size_t c) { bits_[r * words_per_row_ + (c >> 6)] &= ~(uint64_t(1) << (c & 63)); }
+
+        /**
+         * @brief Counts the set cells of a row, i.e. the out-degree of r
+         */
+        size_t rowCount(size_t r) const;
+
+        /**
+         * @brief Lists the set columns of a row in ascending order
+         *
+         * @param r Row to enumerate
+         * @return vector<size_t> Columns c with cell (r, c) set
+         */
+        vector<size_t> neighbors(size_t r) const;
+
+        /**
+         * @brief Counts the columns set in both row a and row b (popcount of a AND b)
+         *
+         * @param a First row
+         * @param b Second row
+         * @return size_t Number of common neighbors
+         */
+        size_t countCommon(size_t a, size_t b) const;
+
+        /**
+         * @brief BFS frontier expansion kernel: visits every neighbor of r not yet in visited.
+         * Computes row(r) AND NOT visited a word at a time, marks the result as visited and
+         * calls fn on each newly visited column in ascending order.
+         *
+         * @param r Row (vertex) being expanded
+         * @param visited Visited bitmap, wordsPerRow() words long
+         * @param fn Callback taking the newly visited column
+         */
+        template <typename Fn>
+        void expand(size_t r, uint64_t* visited, Fn fn) const {
+            const uint64_t* bits = row(r);
+            for (size_t i = 0; i < words_per_row_; ++i) {
+                uint64_t fresh = bits[i] & ~visited[i];
+                visited[i] |= fresh;
+                while (fresh) {
+                    fn((i << 6) + __builtin_ctzll(fresh));
+                    fresh &= fresh - 1;
+                }
+            }
+        }
+
+        /**
+         * @brief Level-synchronous BFS frontier expansion kernel: next = (OR of the rows of every
+         * vertex in frontier) AND NOT visited, then visited |= next.
+         *
+         * @param frontier Bitmap of the current frontier
+         * @param visited Bitmap of visited vertices, updated in place
+         * @param next Output bitmap of the next frontier, overwritten
+         */
+        void expandFrontier(const vector<uint64_t>& frontier, vector<uint64_t>& visited, vector<uint64_t>& next) const;
+
+        friend bool operator==(const BitMatrix& lhs, const BitMatrix& rhs) {
+            return lhs.n_ == rhs.n_ && lhs.bits_ == rhs.bits_;
+        }
+
+    private:
+        /**
+         * @brief Number of rows (and columns)
+         */
+        size_t n_;
+
+        /**
+         * @brief Row stride in words
+         */
+        size_t words_per_row_;
+
+        /**
+         * @brief Row-major bits, n_ * words_per_row_ words
+         */
+        vector<uint64_t> bits_;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using std::vector;
+
+/**
+ * Read-only array that either owns its elements (in a vector) or points into memory owned by
+ * someone else, e.g. a memory mapped Graph snapshot kept alive through a shared_ptr. Reads look
+ * like a const vector and cost the same. To change the contents, take() the elements out as a
+ * vector (copying them out of the mapping if needed), edit it, and assign it back.
+ */
+template <typename T>
+class Buffer {
+    public:
+        /**
+         * @brief Construct an empty, owning Buffer
+         */
+        Buffer() : data_(nullptr), size_(0) {}
+
+        /**
+         * @brief Construct an owning Buffer, taking over the elements of v
+         */
+        Buffer(vector<T>&& v) : owned_(std::move(v)), data_(owned_.data()), size_(owned_.size()) {}
+
+        /**
+         * @brief Construct a Buffer viewing memory it does not own
+         *
+         * @param data First element
+         * @param size Number of elements
+         * @param keep_alive Owner of the memory, held on to for as long as any copy of this Buffer lives
+         */
+        Buffer(const T* data, size_t size, std::shared_ptr<const void> keep_alive)
+            : data_(data), size_(size), keep_alive_(std::move(keep_alive)) {}
+
+        Buffer(const Buffer& other)
+            : owned_(other.owned_), data_(other.keep_alive_ ? other.data_ : owned_.data()),
+              size_(other.size_), keep_alive_(other.keep_alive_) {}
+
+        Buffer(Buffer&& other)
+            : owned_(std::move(other.owned_)), data_(other.keep_alive_ ? other.data_ : owned_.data()),
+              size_(other.size_), keep_alive_(std::move(other.keep_alive_)) {
+            other.reset();
+        }
+
+        Buffer& operator=(Buffer other) {
+            owned_.swap(other.owned_);
+            keep_alive_.swap(other.keep_alive_);
+            data_ = keep_alive_ ? other.data_ : owned_.data();
+            size_ = other.size_;
+            return *this;
+        }
+
+        /**
+         * @brief Replace the contents with the elements of v, owning them
+         */
+        Buffer& operator=(vector<T>&& v) {
+            owned_ = std::move(v);
+            keep_alive_.reset();
+            data_ = owned_.data();
+            size_ = owned_.size();
+            return *this;
+        }
+
+        /**
+         * @brief Moves the elements out as a vector, leaving the Buffer empty. Copies them if they were not owned.
+         */
+        vector<T> take() {
+            vector<T> out = keep_alive_ ? vector<T>(data_, data_ + size_) : std::move(owned_);
+            reset();
+            return out;
+        }
+
+        /**
+         * @brief True if the elements live in someone else's memory (e.g. a mapped snapshot)
+         */
+        inline bool isBorrowed() const { return bool(keep_alive_); }
+
+        inline size_t size() const { return size_; }
+        inline bool empty() const { return size_ == 0; }
+        inline const T* data() const { return data_; }
+        inline const T* begin() const { return data_; }
+        inline const T* end() const { return data_ + size_; }
+        inline const T& operator[](size_t i) const { return data_[i]; }
+        inline const T& back() const { return data_[size_ - 1]; }
+
+        friend bool operator==(const Buffer& lhs, const Buffer& rhs) {
+            return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        inline friend bool operator!=(const Buffer& lhs, const Buffer& rhs) { return !(lhs == rhs); }
+
+    private:
+        /**
+         * @brief Elements, when owned
+         */
+        vector<T> owned_;
+
+        /**
+         * @brief Where the elements are read from: owned_.data() or borrowed memory
+         */
+        const T* data_;
+
+        /**
+         * @brief Number of elements
+         */
+        size_t size_;
+
+        /**
+         * @brief Owner of borrowed memory; null when the elements are owned
+         */
+        std::shared_ptr<const void> keep_alive_;
+
+        void reset() {
+            vector<T>().swap(owned_);
+            keep_alive_.reset();
+            data_ = nullptr;
+            size_ = 0;
+        }
+};
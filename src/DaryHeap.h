@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using std::vector;
+
+typedef size_t Vertex;
+
+/**
+ * Min-heap of (key, Vertex) entries with Arity children per node, kept in one flat array. The array
+ * is 64 byte aligned and the root sits at slot Arity - 1, so the children of node i (at slots
+ * Arity * (i + 1) and up) start on a cache line boundary. With the default of 4, an entry is 16 bytes
+ * and the children of a node are exactly one cache line, so sifting down touches half as many levels
+ * as a binary heap at one line per level.
+ *
+ * There is no decrease-key: push the Vertex again with its smaller key and skip the stale entry
+ * when it comes out (its key no longer matches). The array keeps its capacity across clear().
+ */
+template <size_t Arity = 4>
+class DaryHeap {
+    public:
+        struct Entry {
+            double key;
+            Vertex vertex;
+        };
+
+        DaryHeap() : base_(nullptr), size_(0), capacity_(0) {}
+
+        inline bool empty() const { return size_ == 0; }
+        inline size_t size() const { return size_; }
+        inline void clear() { size_ = 0; }
+
+        /**
+         * @brief Entry with the smallest key. The heap must not be empty.
+         */
+        inline const Entry& top() const { return at(0); }
+
+        /**
+         * @brief Adds v with key
+         */
+        void push(double key, Vertex v) {
+            if (size_ == capacity_) grow();
+            size_t i = size_++;
+            // move parents down until the new entry fits
+            while (i > 0) {
+                size_t parent = (i - 1) / Arity;
+                if (at(parent).key <= key) break;
+                at(i) = at(parent);
+                i = parent;
+            }
+            at(i).key = key;
+            at(i).vertex = v;
+        }
+
+        /**
+         * @brief Removes top(). The heap must not be empty.
+         */
+        void pop() {
+            Entry last = at(--size_);
+            size_t n = size_;
+            if (n == 0)
+                return;
+            // move the smallest child up until last fits
+            size_t i = 0;
+            for (;;) {
+                size_t first = i * Arity + 1;
+                if (first >= n) break;
+                size_t end = first + Arity < n ? first + Arity : n, smallest = first;
+                for (size_t c = first + 1; c < end; ++c) {
+                    if (at(c).key < at(smallest).key) smallest = c;
+                }
+                if (last.key <= at(smallest).key) break;
+                at(i) = at(smallest);
+                i = smallest;
+            }
+            at(i) = last;
+        }
+
+    private:
+        static const size_t LINE = 64;
+
+        /**
+         * @brief The raw allocation, and base_ aligned to LINE inside it. Node i is base_[i + Arity - 1].
+         */
+        std::unique_ptr<char[]> raw_;
+        Entry* base_;
+        size_t size_, capacity_;
+
+        inline Entry& at(size_t i) { return base_[i + Arity - 1]; }
+        inline const Entry& at(size_t i) const { return base_[i + Arity - 1]; }
+
+        /**
+         * @brief Helper function: Doubles the capacity, moving the entries to a new aligned array
+         */
+        void grow() {
+            size_t capacity = capacity_ ? 2 * capacity_ : 64;
+            std::unique_ptr<char[]> raw(new char[(capacity + Arity - 1) * sizeof(Entry) + LINE]);
+            uintptr_t address = reinterpret_cast<uintptr_t>(raw.get());
+            Entry* base = reinterpret_cast<Entry*>((address + LINE - 1) / LINE * LINE);
+            if (size_) std::memcpy(base + Arity - 1, base_ + Arity - 1, size_ * sizeof(Entry));
+            raw_ = std::move(raw);
+            base_ = base;
+            capacity_ = capacity;
+        }
+};
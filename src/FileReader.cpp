@@ -1,5 +1,14 @@
 #include "FileReader.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
 vector<string> FileReader::fileToVector(const string& file_name) {
     std::ifstream text(file_name);
     vector<string> out_vec;
@@ -13,4 +22,192 @@ vector<string> FileReader::fileToVector(const string& file_name) {
     }
 
     return out_vec;
-}
\ No newline at end of file
+}
+
+vector<uint64_t> FileReader::fileToIds(const string& file_name) {
+    vector<uint64_t> out_vec;
+    MappedFile file(file_name, true);
+    if (!file.is_open())
+        return out_vec;
+
+    // ids in SNAP files average a bit under 6 bytes each with their separator
+    out_vec.reserve(file.size() / 6 + 2);
+    parseIds(file.data(), file.data() + file.size(), out_vec);
+    return out_vec;
+}
+
+vector<uint64_t> FileReader::fileToIdsParallel(const string& file_name, unsigned num_threads) {
+    vector<uint64_t> out_vec;
+    MappedFile file(file_name, true);
+    if (!file.is_open())
+        return out_vec;
+
+    // When picking automatically, threads are not worth starting for less than 1 MB of text each
+    if (num_threads == 0) num_threads = unsigned(std::min<size_t>(std::thread::hardware_concurrency(), file.size() >> 20));
+    num_threads = unsigned(std::max<size_t>(1, std::min<size_t>(num_threads, file.size())));
+
+    // Chunk boundaries, each moved forward to the start of the next line
+    const char* begin = file.data();
+    const char* end = file.data() + file.size();
+    vector<const char*> bounds(num_threads + 1, end);
+    bounds[0] = begin;
+    for (unsigned t = 1; t < num_threads; ++t) {
+        const char* p = std::max(begin + file.size() / num_threads * t, bounds[t - 1]);
+        while (p < end && *p != '\n') p++;
+        bounds[t] = p < end ? p + 1 : end;
+    }
+
+    // Parse each chunk into its own buffer
+    vector<vector<uint64_t>> parts(num_threads);
+    vector<std::thread> workers;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        workers.emplace_back([&parts, &bounds, t] {
+            parts[t].reserve((bounds[t + 1] - bounds[t]) / 6 + 2);
+            parseIds(bounds[t], bounds[t + 1], parts[t]);
+        });
+    }
+    for (std::thread& w : workers) w.join();
+
+    // Stitch the buffers together in file order, copying concurrently too
+    vector<size_t> offsets(num_threads + 1, 0);
+    for (unsigned t = 0; t < num_threads; ++t) offsets[t + 1] = offsets[t] + parts[t].size();
+    out_vec.resize(offsets[num_threads]);
+
+    workers.clear();
+    for (unsigned t = 0; t < num_threads; ++t) {
+        workers.emplace_back([&parts, &offsets, &out_vec, t] {
+            std::copy(parts[t].begin(), parts[t].end(), out_vec.begin() + offsets[t]);
+            vector<uint64_t>().swap(parts[t]);
+        });
+    }
+    for (std::thread& w : workers) w.join();
+
+    return out_vec;
+}
+
+unsigned FileReader::leadingDigits(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+
+    // Per byte, without carries between bytes: a digit is 0x30 <= b <= 0x39 with the high bit clear
+    const uint64_t high = 0x8080808080808080ULL;
+    uint64_t low7 = v & ~high;
+    uint64_t at_least_0 = (low7 + 0x5050505050505050ULL) & high;
+    uint64_t above_9 = (low7 + 0x4646464646464646ULL) & high;
+    uint64_t non_digit = ~(at_least_0 & ~above_9 & ~v) & high;
+
+    // first byte of the text is the lowest byte of v
+    return non_digit ? __builtin_ctzll(non_digit) >> 3 : 8;
+}
+
+uint64_t FileReader::parseDigits(const char* p, unsigned len) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+
+    // Turn the characters into digit values and shift the extra bytes out, so the number
+    // is right-aligned as if it had (8 - len) leading zeros
+    v = (v - 0x3030303030303030ULL) << (8 * (8 - len));
+
+    // Combine neighbouring digits pairwise: 1-digit -> 2-digit -> 4-digit -> 8-digit lanes
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return v;
+}
+
+void FileReader::parseIds(const char* begin, const char* end, vector<uint64_t>& out) {
+    static const uint64_t pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+    const char* p = begin;
+    // fields is how many ids of the current line have been read, first the first of them;
+    // a dropped line has its remaining tokens skipped
+    unsigned fields = 0;
+    uint64_t first = 0;
+    bool dropped = false;
+
+    while (p < end) {
+        char c = *p;
+        if (c == '\n') {
+            fields = 0;
+            dropped = false;
+            p++;
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r') {
+            p++;
+            continue;
+        }
+
+        // comment line, trailing columns (timestamps, weights) or the rest of a dropped line: skip the token
+        bool comment = fields == 0 && !dropped && (c == '#' || c == '%');
+        if (comment || fields == 2 || dropped) {
+            dropped = dropped || comment;
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+            continue;
+        }
+
+        // accumulate digits, 8 at a time while there is room to load a whole word. Below 10^11 another 8
+        // digits always fit, so only larger ids pay for the overflow check.
+        uint64_t id = 0;
+        bool overflow = false;
+        while (end - p >= 8) {
+            unsigned len = leadingDigits(p);
+            if (len == 0) break;
+            uint64_t digits = parseDigits(p, len);
+            if (id >= 100000000000ULL && id > (UINT64_MAX - digits) / pow10[len]) overflow = true;
+            id = id * pow10[len] + digits;
+            p += len;
+            if (len < 8) break;
+        }
+        for (; p < end && unsigned(*p - '0') < 10; ++p) {
+            uint64_t digit = uint64_t(*p - '0');
+            if (id > (UINT64_MAX - digit) / 10) overflow = true;
+            id = id * 10 + digit;
+        }
+
+        // a token with anything else in it, or too large for 64 bits, drops the whole line, so later ids
+        // keep their partners
+        if (overflow || (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')) {
+            dropped = true;
+            continue;
+        }
+        if (fields++ == 0) {
+            first = id;
+            continue;
+        }
+        out.push_back(first);
+        out.push_back(id);
+    }
+}
+
+MappedFile::MappedFile(const string& file_name, bool sequential) : data_(nullptr), size_(0), open_(false), mapped_(false) {
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    open_ = true;
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        size_ = size_t(info.st_size);
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            // a parser only walks forward, so pages behind it can go; a snapshot keeps the default
+            // read-ahead, since traversals read its CSR arrays in any order
+            if (sequential) ::madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+
+    // mmap not possible (e.g. a pipe): read it the old-fashioned way
+    if (!mapped_) {
+        std::ifstream text(file_name, std::ios::binary);
+        fallback_.assign(std::istreambuf_iterator<char>(text), std::istreambuf_iterator<char>());
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+}
@@ -7,13 +7,113 @@
 #include <cstdlib>
 #include <sstream>
 #include <iterator>
+#include <cstdint>
+#include <cstring>
 
 using std::string;
 using std::vector;
 
+/**
+ * Read-only view of a whole file, memory mapped so it can be parsed in place without copying.
+ * Falls back to reading the file into memory if it cannot be mapped.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps file_name. Check is_open() afterwards.
+     * 
+     * @param file_name Path of the file to map
+     * @param sequential If true, the file will be read once from start to end (e.g. parsed), and the
+     * kernel is told so. Leave false for a mapping that is read randomly, like a loaded snapshot.
+     */
+    explicit MappedFile(const string& file_name, bool sequential = false);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief First byte of the file. Not null terminated!
+     */
+    inline const char* data() const { return data_; }
+
+    /**
+     * @brief Size of the file in bytes
+     */
+    inline size_t size() const { return size_; }
+
+    /**
+     * @brief True if the file could be opened
+     */
+    inline bool is_open() const { return open_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    bool open_;
+    bool mapped_;
+
+    /**
+     * @brief Holds the file contents when mmap is not available
+     */
+    vector<char> fallback_;
+};
+
 class FileReader {
 
 public:
     static vector<string> fileToVector(const string& file_name);
 
+    /**
+     * @brief Reads an edge list of non-negative integer ids (e.g. a SNAP dataset) straight out of a memory
+     * mapping, with no intermediate strings. Same layout as fileToVector - an Edge is an id followed by
+     * the next one, so [1, 2, 3, 2] is 1->2 and 3->2 - but already parsed. Each line is one Edge: its first
+     * two columns are the ids and any later ones (timestamps, weights) are ignored. Lines starting with '#'
+     * or '%' are comments, and lines without two integer ids in front (or with one over 2^64 - 1) are dropped whole.
+     * 
+     * @param file_name Path of the edge list
+     * @return vector<uint64_t> Flat list of ids, two per Edge. Empty if the file cannot be opened.
+     */
+    static vector<uint64_t> fileToIds(const string& file_name);
+
+    /**
+     * @brief Multi-threaded fileToIds. Splits the mapped file into one chunk per thread at line
+     * boundaries, parses the chunks concurrently and concatenates the results in file order,
+     * so the output is identical to fileToIds.
+     * 
+     * @param file_name Path of the edge list
+     * @param num_threads Worker threads to use; 0 picks std::thread::hardware_concurrency(), less for small files
+     * @return vector<uint64_t> Flat list of ids, two per Edge. Empty if the file cannot be opened.
+     */
+    static vector<uint64_t> fileToIdsParallel(const string& file_name, unsigned num_threads = 0);
+
+    /**
+     * @brief Parses the ids out of an in-memory edge list. Used by fileToIds. The text should start at
+     * the beginning of a line.
+     * 
+     * @param begin First byte to parse
+     * @param end One past the last byte to parse
+     * @param out Ids are appended here
+     */
+    static void parseIds(const char* begin, const char* end, vector<uint64_t>& out);
+
+    /**
+     * @brief Counts how many of the first 8 bytes at p are ASCII digits, all at once (SWAR)
+     * 
+     * @param p At least 8 readable bytes
+     * @return unsigned Length of the leading run of digits, 0 to 8
+     */
+    static unsigned leadingDigits(const char* p);
+
+    /**
+     * @brief Converts the first len (1 to 8) bytes at p, all digits, to an integer with three
+     * multiplies instead of len (SWAR)
+     * 
+     * @param p At least 8 readable bytes
+     * @param len Number of digits to convert
+     * @return uint64_t Value of the digits
+     */
+    static uint64_t parseDigits(const char* p, unsigned len);
+
 };
\ No newline at end of file
@@ -1,45 +1,160 @@
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
 
+#include <sys/stat.h>
+
+#include "DaryHeap.h"
 #include "Graph.h"
+#include "FileReader.h"
+#include "ThreadPool.h"
 
 /****************************** Graph Functions ******************************/
 
-void Graph::__init(const vector<Edge>& edges, size_t num_nodes, bool double_directed) {
+template <typename Weight, typename Direction>
+BasicGraph<Weight, Direction>::BasicGraph() {
+    __init(vector<Edge>(), 0, true);
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::__init(const vector<Edge>& edges, size_t num_nodes, bool double_directed) {
+    __build(edges.size(), [&edges](size_t i) { return edges[i]; }, num_nodes, double_directed);
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::__init(const vector<uint64_t>& ids, size_t num_nodes, bool double_directed) {
+    __build(ids.size() / 2, [&ids](size_t i) { return Edge(ids[2 * i], ids[2 * i + 1]); }, num_nodes, double_directed);
+}
+
+template <typename Weight, typename Direction>
+template <typename EdgeAt>
+void BasicGraph<Weight, Direction>::__build(size_t num_edges, EdgeAt edge_at, size_t num_nodes, bool double_directed) {
+    // A Directed or Undirected Graph ignores the flag
+    if (!Direction::runtime) double_directed = Direction::symmetric;
     is_double_directed = double_directed;
-    // Initialize adjacency matrix
-    matrix_.clear();
-    vertices.clear();
-    for (size_t i = 0; i < num_nodes; ++i) {
-        vector<double> line(num_nodes, 0.0);
-        matrix_.push_back(line);
+    vector<Vertex> seen;
+
+    // Count the Edges leaving each Vertex, then prefix sum the counts into row offsets
+    vector<size_t> bucket(num_nodes + 1, 0);
+    for (size_t i = 0; i < num_edges; ++i) {
+        Edge e = edge_at(i);
+        bucket[e.start + 1]++;
+        if (double_directed) bucket[e.end + 1]++;
     }
+    for (size_t i = 0; i < num_nodes; ++i) bucket[i + 1] += bucket[i];
+
+    // Scatter the Edges into their rows, keeping the input order within each row
+    vector<Vertex> row_ends(bucket[num_nodes]);
+    vector<double> row_weights(bucket[num_nodes]);
+    vector<size_t> cursor(bucket.begin(), bucket.end() - 1);
+    vector<bool> registered(num_nodes, false);
+    for (size_t i = 0; i < num_edges; ++i) {
+        Edge e = edge_at(i);
+        row_ends[cursor[e.start]] = e.end;
+        row_weights[cursor[e.start]++] = e.weight;
+
+        if (double_directed) {
+            row_ends[cursor[e.end]] = e.start;
+            row_weights[cursor[e.end]++] = e.weight;
+        }
 
-    for (Edge e : edges) {
-        matrix_[e.start][e.end] = e.weight; 
-
-        if (double_directed)
-            matrix_[e.end][e.start] = e.weight;
-        
-        // Initializes vertices vector
-        // Check if first vertex already in vertices vector
-        if (std::find(vertices.begin(), vertices.end(), e.start) == vertices.end()) {
-            vertices.push_back(e.start);
+        // Initializes vertices vector, in order of first appearance
+        // Check if first vertex already in vertices vector (O(1) through the presence bitmap)
+        if (!registered[e.start]) {
+            registered[e.start] = true;
+            seen.push_back(e.start);
         }
         // Check if second vertex already in vertices vector
-        if (std::find(vertices.begin(), vertices.end(), e.end) == vertices.end()) {
-            vertices.push_back(e.end);
+        if (!registered[e.end]) {
+            registered[e.end] = true;
+            seen.push_back(e.end);
+        }
+    }
+
+    // Sort each row by ending Vertex. A repeated Edge keeps the weight it was given last and
+    // an Edge of weight 0 does not exist, same as writing them into an adjacency matrix would.
+    vector<size_t> offsets(num_nodes + 1, 0);
+    vector<Vertex> neighbors;
+    vector<Stored> weights;
+    neighbors.reserve(row_ends.size());
+    weights.reserve(row_ends.size());
+    vector<std::pair<Vertex, double>> row;
+    bool unweighted = true;
+    for (size_t v = 0; v < num_nodes; ++v) {
+        row.clear();
+        for (size_t i = bucket[v]; i < bucket[v + 1]; ++i) row.emplace_back(row_ends[i], row_weights[i]);
+        std::stable_sort(row.begin(), row.end(), [](const std::pair<Vertex, double>& a, const std::pair<Vertex, double>& b) {
+            return a.first < b.first;
+        });
+
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (i + 1 < row.size() && row[i + 1].first == row[i].first) continue;
+            Stored w = WeightTraits<Weight>::store(row[i].second);
+            if (w == 0) continue;
+            neighbors.push_back(row[i].first);
+            if (WeightTraits<Weight>::weighted) weights.push_back(w);
+            unweighted = unweighted && w == 1;
+        }
+        offsets[v + 1] = neighbors.size();
+    }
+
+    if (unweighted) vector<Stored>().swap(weights);
+    neighbors.shrink_to_fit();
+    weights.shrink_to_fit();
+    offsets_ = std::move(offsets);
+    neighbors_ = std::move(neighbors);
+    weights_ = std::move(weights);
+    vertices = std::move(seen);
+
+    bits_ = BitMatrix();
+
+    // A double directed Graph is its own transpose, so it only needs the incoming index once it stops being symmetric
+    in_shared_ = double_directed;
+    if (in_shared_) {
+        in_offsets_ = Buffer<size_t>();
+        in_neighbors_ = Buffer<Vertex>();
+        in_weights_ = Buffer<Stored>();
+    } else buildIncomingIndex();
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::buildIncomingIndex() {
+    // Counting sort of the Edges by ending Vertex. Rows are visited in ascending order,
+    // so each incoming row comes out sorted by starting Vertex.
+    size_t n = getSize();
+    vector<size_t> in_offsets(n + 1, 0);
+    for (Vertex end : neighbors_) in_offsets[end + 1]++;
+    for (size_t i = 0; i < n; ++i) in_offsets[i + 1] += in_offsets[i];
+
+    vector<Vertex> in_neighbors(neighbors_.size());
+    vector<Stored> in_weights(weights_.size());
+    vector<size_t> cursor(in_offsets.begin(), in_offsets.end() - 1);
+    for (Vertex start = 0; start < n; ++start) {
+        for (size_t k = offsets_[start]; k < offsets_[start + 1]; ++k) {
+            size_t pos = cursor[neighbors_[k]]++;
+            in_neighbors[pos] = start;
+            if (!weights_.empty()) in_weights[pos] = weights_[k];
         }
     }
+
+    in_offsets_ = std::move(in_offsets);
+    in_neighbors_ = std::move(in_neighbors);
+    in_weights_ = std::move(in_weights);
 }
 
-Graph::Graph(const vector<string>& lines, bool double_directed) {
-    vector<Graph::Edge> edges;
+template <typename Weight, typename Direction>
+BasicGraph<Weight, Direction>::BasicGraph(const vector<string>& lines, bool double_directed) {
+    vector<Edge> edges;
 
     Vertex max_node = 0;
     for (size_t i = 0; i < lines.size()/2; ++i) {
-        Graph::Edge edge(lines[2*i], lines[2*i + 1], 1);
+        Edge edge(lines[2*i], lines[2*i + 1], 1);
         edges.push_back(edge);
         max_node = std::max(edge.maxVertex(), max_node);
     }
@@ -47,89 +162,504 @@ Graph::Graph(const vector<string>& lines, bool double_directed) {
     __init(edges, max_node + 1, double_directed);
 }
 
-Graph::Graph(const vector<Edge>& edges, size_t num_nodes, bool double_directed) {
+template <typename Weight, typename Direction>
+BasicGraph<Weight, Direction>::BasicGraph(const vector<uint64_t>& ids, bool double_directed) {
+    // Parsed ids go straight into the CSR build, without making Edges first
+    uint64_t max_node = 0;
+    for (size_t i = 0; i < ids.size() / 2 * 2; ++i) max_node = std::max(ids[i], max_node);
+
+    __init(ids, max_node + 1, double_directed);
+}
+
+template <typename Weight, typename Direction>
+BasicGraph<Weight, Direction>::BasicGraph(const vector<Edge>& edges, size_t num_nodes, bool double_directed) {
     __init(edges, num_nodes, double_directed);
 }
 
-bool Graph::areConnected(const Edge& e) const {
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::areConnected(const Edge& e) const {
     return areConnected(e.start, e.end);
 }
 
-bool Graph::areConnected(Vertex start, Vertex end) const {
-    if (start >= matrix_.size() || end >= matrix_.size())
-        return false;
-    return (matrix_[start][end] != 0);
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::areConnected(Vertex start, Vertex end) const {
+    return findEdge(start, end) != neighbors_.size();
+}
+
+template <typename Weight, typename Direction>
+size_t BasicGraph<Weight, Direction>::findEdge(Vertex start, Vertex end) const {
+    if (start >= getSize() || end >= getSize())
+        return neighbors_.size();
+
+    // Rows are sorted, so binary search the row of start
+    auto first = neighbors_.begin() + offsets_[start], last = neighbors_.begin() + offsets_[start + 1];
+    auto it = std::lower_bound(first, last, end);
+    if (it == last || *it != end)
+        return neighbors_.size();
+    return it - neighbors_.begin();
 }
 
-void Graph::changeWeight(const Edge& e) {
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::changeWeight(const Edge& e) {
     changeWeight(e.start, e.end, e.weight);
 }
 
-void Graph::changeWeight(Vertex start, Vertex end, double weight) {
-    if (start > matrix_.size() || end >= matrix_.size())
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::changeWeight(Vertex start, Vertex end, double weight) {
+    if (start >= getSize() || end >= getSize())
         return;
-    matrix_[start][end] = weight;
+
+    // The change only goes one way, so the Graph may stop being its own transpose
+    if (Direction::runtime && in_shared_ && start != end) {
+        in_offsets_ = offsets_;
+        in_neighbors_ = neighbors_;
+        in_weights_ = weights_;
+        in_shared_ = false;
+    }
+
+    // Edit through vectors taken out of the Buffers; a mapped snapshot gets copied into memory here
+    vector<size_t> offsets = offsets_.take();
+    vector<Vertex> neighbors = neighbors_.take();
+    vector<Stored> weights = weights_.take();
+    setEntry(offsets, neighbors, weights, start, end, weight);
+    // Undirected Graphs stay symmetric, so they never need the incoming index
+    if (Direction::symmetric && start != end) setEntry(offsets, neighbors, weights, end, start, weight);
+    offsets_ = std::move(offsets);
+    neighbors_ = std::move(neighbors);
+    weights_ = std::move(weights);
+
+    if (!inShared()) {
+        offsets = in_offsets_.take();
+        neighbors = in_neighbors_.take();
+        weights = in_weights_.take();
+        setEntry(offsets, neighbors, weights, end, start, weight);
+        in_offsets_ = std::move(offsets);
+        in_neighbors_ = std::move(neighbors);
+        in_weights_ = std::move(weights);
+    }
+
+    // The bit matrix only tracks which Edges exist; their weights stay in the CSR arrays
+    if (hasBitMatrix()) {
+        bool exists = WeightTraits<Weight>::store(weight) != 0;
+        if (exists) bits_.set(start, end);
+        else bits_.reset(start, end);
+        if (Direction::symmetric) exists ? bits_.set(end, start) : bits_.reset(end, start);
+    }
 }
 
-double Graph::getWeight(const Edge& e) const {
-    return getWeight(e.start, e.end);
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::useBitMatrix(size_t max_nodes) {
+    if (hasBitMatrix())
+        return true;
+    if (!weights_.empty() || getSize() == 0 || getSize() > max_nodes)
+        return false;
+
+    bits_ = BitMatrix(getSize());
+    for (Vertex v = 0; v < getSize(); ++v) {
+        for (size_t k = offsets_[v]; k < offsets_[v + 1]; ++k) bits_.set(v, neighbors_[k]);
+    }
+    return true;
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::dropBitMatrix() {
+    bits_ = BitMatrix();
 }
 
-double Graph::getWeight(Vertex start, Vertex end) const {
-    if (!areConnected(start, end))
+template <typename Weight, typename Direction>
+size_t BasicGraph<Weight, Direction>::countCommonNeighbors(Vertex a, Vertex b) const {
+    if (a >= getSize() || b >= getSize())
         return 0;
-    return matrix_[start][end];
+    if (hasBitMatrix())
+        return bits_.countCommon(a, b);
+
+    // Merge the two sorted CSR rows
+    size_t i = offsets_[a], j = offsets_[b], count = 0;
+    while (i < offsets_[a + 1] && j < offsets_[b + 1]) {
+        if (neighbors_[i] < neighbors_[j]) i++;
+        else if (neighbors_[j] < neighbors_[i]) j++;
+        else count++, i++, j++;
+    }
+    return count;
 }
 
-vector<Graph::Edge> Graph::getOutgoingEdges(Vertex start) const {
-    vector<Edge> edges;
-    if (start >= matrix_.size())
-        return edges;
+template <typename Weight, typename Direction>
+size_t BasicGraph<Weight, Direction>::countTriangles() const {
+    // Each triangle a < b < c is found once, from its smallest Vertex: for every b > a in row a,
+    // count the c > b that rows a and b share
+    size_t count = 0;
+    for (Vertex a = 0; a < getSize(); ++a) {
+        size_t end_a = offsets_[a + 1];
+        size_t k = std::upper_bound(neighbors_.begin() + offsets_[a], neighbors_.begin() + end_a, a) - neighbors_.begin();
+        for (; k < end_a; ++k) {
+            Vertex b = neighbors_[k];
+            size_t i = k + 1, j = std::upper_bound(neighbors_.begin() + offsets_[b], neighbors_.begin() + offsets_[b + 1], b) - neighbors_.begin();
+            while (i < end_a && j < offsets_[b + 1]) {
+                if (neighbors_[i] < neighbors_[j]) i++;
+                else if (neighbors_[j] < neighbors_[i]) j++;
+                else count++, i++, j++;
+            }
+        }
+    }
+    return count;
+}
 
-    for (size_t j = 0; j < matrix_[start].size(); ++j) {
-        if (matrix_[start][j] != 0)
-            edges.emplace_back(start, j, matrix_[start][j]);
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::reorder(const vector<Vertex>& new_id) {
+    size_t n = getSize();
+    if (new_id.size() != n)
+        return false;
+    vector<bool> taken(n, false);
+    for (Vertex id : new_id) {
+        if (id >= n || taken[id])
+            return false;
+        taken[id] = true;
     }
-    return edges;
+
+    // Row new_id[v] is row v with its columns relabeled, then re-sorted
+    vector<size_t> offsets(n + 1, 0);
+    for (Vertex v = 0; v < n; ++v) offsets[new_id[v] + 1] = offsets_[v + 1] - offsets_[v];
+    for (size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+
+    vector<Vertex> neighbors(neighbors_.size());
+    vector<Stored> weights(weights_.size());
+    vector<std::pair<Vertex, Stored>> row;
+    for (Vertex v = 0; v < n; ++v) {
+        row.clear();
+        for (size_t k = offsets_[v]; k < offsets_[v + 1]; ++k) row.emplace_back(new_id[neighbors_[k]], weights_.empty() ? 1 : weights_[k]);
+        std::sort(row.begin(), row.end());
+        size_t pos = offsets[new_id[v]];
+        for (size_t i = 0; i < row.size(); ++i) {
+            neighbors[pos + i] = row[i].first;
+            if (!weights.empty()) weights[pos + i] = row[i].second;
+        }
+    }
+
+    vector<Vertex> relabeled(vertices.begin(), vertices.end());
+    for (Vertex& v : relabeled) v = new_id[v];
+
+    offsets_ = std::move(offsets);
+    neighbors_ = std::move(neighbors);
+    weights_ = std::move(weights);
+    vertices = std::move(relabeled);
+    if (!inShared()) buildIncomingIndex();
+    if (hasBitMatrix()) {
+        bits_ = BitMatrix();
+        useBitMatrix(n);
+    }
+    return true;
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::setEntry(vector<size_t>& offsets, vector<Vertex>& cols, vector<Stored>& weights,
+                                             Vertex row, Vertex col, double weight) {
+    // Everything below works on the weight as stored, e.g. 0.4 is no Edge in a uint8_t Graph
+    Stored w = WeightTraits<Weight>::store(weight);
+    auto first = cols.begin() + offsets[row], last = cols.begin() + offsets[row + 1];
+    auto it = std::lower_bound(first, last, col);
+    size_t idx = it - cols.begin();
+
+    if (it != last && *it == col) {
+        // Existing Edge: a weight of 0 removes it, anything else overwrites in place
+        if (w == 0) {
+            cols.erase(it);
+            if (!weights.empty()) weights.erase(weights.begin() + idx);
+            for (size_t v = row + 1; v < offsets.size(); ++v) offsets[v]--;
+            return;
+        }
+        if (WeightTraits<Weight>::weighted && weights.empty() && w != 1) weights.assign(cols.size(), 1);
+        if (!weights.empty()) weights[idx] = w;
+        return;
+    }
+    if (w == 0)
+        return;
+
+    // New Edge: splice it into its sorted position in the row. O(E), so prefer
+    // building the Graph with all of its Edges up front.
+    if (WeightTraits<Weight>::weighted && weights.empty() && w != 1) weights.assign(cols.size(), 1);
+    cols.insert(it, col);
+    if (!weights.empty()) weights.insert(weights.begin() + idx, w);
+    for (size_t v = row + 1; v < offsets.size(); ++v) offsets[v]++;
+}
+
+template <typename Weight, typename Direction>
+double BasicGraph<Weight, Direction>::getWeight(const Edge& e) const {
+    return getWeight(e.start, e.end);
 }
 
-vector<Graph::Edge> Graph::getIncomingEdges(Vertex end) const {
+template <typename Weight, typename Direction>
+double BasicGraph<Weight, Direction>::getWeight(Vertex start, Vertex end) const {
+    size_t idx = findEdge(start, end);
+    if (idx == neighbors_.size())
+        return 0;
+    return weightAt(idx);
+}
+
+template <typename Weight, typename Direction>
+vector<Edge> BasicGraph<Weight, Direction>::getOutgoingEdges(Vertex start) const {
+    Neighbors adj = neighbors(start);
     vector<Edge> edges;
-    if (end >= matrix_.size())
-        return edges;
+    edges.reserve(adj.size());
+    for (size_t i = 0; i < adj.size(); ++i)
+        edges.emplace_back(start, adj[i], adj.weight(i));
+    return edges;
+}
 
-    for (size_t i = 0; i < matrix_.size(); i++) {
-        if (matrix_[i][end] != 0)
-            edges.emplace_back(i, end, matrix_[i][end]);
-    }
+template <typename Weight, typename Direction>
+vector<Edge> BasicGraph<Weight, Direction>::getIncomingEdges(Vertex end) const {
+    Neighbors adj = inNeighbors(end);
+    vector<Edge> edges;
+    edges.reserve(adj.size());
+    for (size_t i = 0; i < adj.size(); ++i)
+        edges.emplace_back(adj[i], end, adj.weight(i));
     return edges;
 }
 
-vector<Vertex> Graph::get_vertices() {
-    return vertices;
+template <typename Weight, typename Direction>
+vector<Vertex> BasicGraph<Weight, Direction>::get_vertices() {
+    return vector<Vertex>(vertices.begin(), vertices.end());
 }
 
-bool operator==(const Graph& lhs, const Graph& rhs) {
-    if (lhs.matrix_.size() != rhs.matrix_.size() || lhs.matrix_[0].size() != rhs.matrix_.size())
+template <typename Weight, typename Direction>
+vector<vector<double>> BasicGraph<Weight, Direction>::getAdjacencyMatrix() const {
+    vector<vector<double>> matrix(getSize(), vector<double>(getSize(), 0.0));
+    for (size_t i = 0; i < getSize(); i++) {
+        for (size_t k = offsets_[i]; k < offsets_[i + 1]; k++) matrix[i][neighbors_[k]] = weightAt(k);
+    }
+    return matrix;
+}
+
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::equals(const BasicGraph& other) const {
+    // Both sides are kept sorted and free of duplicates, so equal matrices means equal CSR arrays
+    if (offsets_ != other.offsets_ || neighbors_ != other.neighbors_)
         return false;
 
-    for (size_t i = 0; i < lhs.matrix_.size(); i++) {
-        for (size_t j = 0; j < lhs.matrix_[i].size(); j++) {
-            if (lhs.matrix_[i][j] != rhs.matrix_[i][j])
-                return false;
-        }
+    for (size_t i = 0; i < neighbors_.size(); i++) {
+        if (weightAt(i) != other.weightAt(i))
+            return false;
     }
 
     return true;
 }
 
-std::ostream& operator<<(std::ostream& out, const Graph& g) {
-    for (size_t i = 0; i < g.matrix_.size(); i++) {
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::print(std::ostream& out) const {
+    for (size_t i = 0; i < getSize(); i++) {
         out << "[ ";
-        for (size_t j = 0; j < g.matrix_.at(i).size(); j++) out << g.matrix_[i][j] << " ";
+        size_t k = offsets_[i];
+        for (size_t j = 0; j < getSize(); j++) {
+            if (k < offsets_[i + 1] && neighbors_[k] == j) out << weightAt(k++) << " ";
+            else out << 0 << " ";
+        }
         out << "]" << std::endl;
     }
-    return out;
+}
+
+/****************************** Snapshot Functions ******************************/
+
+/**
+ * Fixed-size header at the start of a snapshot file. Every array follows it, in the order
+ * offsets, neighbors, weights, in_offsets, in_neighbors, in_weights, vertices, as raw little-endian
+ * 8-byte words. The weights are stored in the Graph's Weight type (weight_type, see WeightTraits),
+ * zero padded to a whole word. The checksum covers everything after the header. source_size and
+ * source_mtime identify the text file the Graph was parsed from (all zero if not given).
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian_tag;
+    uint32_t flags;
+    uint32_t weight_type;
+    uint64_t num_nodes;
+    uint64_t num_edges;
+    uint64_t num_weights;
+    uint64_t num_in_edges;
+    uint64_t num_in_weights;
+    uint64_t num_vertices;
+    uint64_t checksum;
+    uint64_t source_size;
+    int64_t source_mtime;
+};
+
+static const char SNAPSHOT_MAGIC[8] = {'F', 'B', 'G', 'R', 'A', 'P', 'H', '\0'};
+static const uint32_t SNAPSHOT_VERSION = 3;
+static const uint32_t SNAPSHOT_ENDIAN_TAG = 0x01020304;
+static const uint32_t SNAPSHOT_DOUBLE_DIRECTED = 1, SNAPSHOT_IN_SHARED = 2;
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "snapshot arrays must stay 8-byte aligned");
+static_assert(sizeof(size_t) == 8 && sizeof(Vertex) == 8, "snapshot offsets and Vertices are 8-byte words");
+
+/**
+ * @brief Number of 8-byte words count elements of size bytes each take up, once padded
+ */
+static uint64_t paddedWords(uint64_t count, size_t size) {
+    return (count * size + 7) / 8;
+}
+
+/**
+ * @brief Folds num_bytes bytes into a running checksum, a word at a time. A partial last word
+ * is zero padded, the same as it is in the file.
+ */
+static uint64_t checksumWords(uint64_t h, const void* data, size_t num_bytes) {
+    const char* bytes = static_cast<const char*>(data);
+    for (size_t i = 0; i < num_bytes; i += 8) {
+        uint64_t w = 0;
+        std::memcpy(&w, bytes + i, std::min<size_t>(8, num_bytes - i));
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+/**
+ * @brief Size and modification time (in nanoseconds) of a file, false if it cannot be found
+ */
+static bool fileStamp(const string& file_name, uint64_t& size, int64_t& mtime) {
+    struct stat info;
+    if (::stat(file_name.c_str(), &info) != 0)
+        return false;
+    size = uint64_t(info.st_size);
+    mtime = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    return true;
+}
+
+/**
+ * @brief If n + 1 row offsets and the m neighbor ids they index (raw 8-byte words, as in a snapshot) make a
+ * well-formed CSR index: offsets start at 0, never decrease and end at m, and every id is below n
+ */
+static bool validCsr(const uint64_t* offsets, const uint64_t* neighbors, uint64_t n, uint64_t m) {
+    if (offsets[0] != 0 || offsets[n] != m)
+        return false;
+    for (uint64_t v = 0; v < n; ++v) {
+        if (offsets[v] > offsets[v + 1]) return false;
+    }
+    for (uint64_t i = 0; i < m; ++i) {
+        if (neighbors[i] >= n) return false;
+    }
+    return true;
+}
+
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::saveSnapshot(const string& file_name, const string& source) const {
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.endian_tag = SNAPSHOT_ENDIAN_TAG;
+    header.weight_type = WeightTraits<Weight>::code;
+    header.flags = (is_double_directed ? SNAPSHOT_DOUBLE_DIRECTED : 0) | (inShared() ? SNAPSHOT_IN_SHARED : 0);
+    header.num_nodes = getSize();
+    header.num_edges = neighbors_.size();
+    header.num_weights = weights_.size();
+    header.num_in_edges = in_neighbors_.size();
+    header.num_in_weights = in_weights_.size();
+    header.num_vertices = vertices.size();
+    if (!source.empty() && !fileStamp(source, header.source_size, header.source_mtime))
+        return false;
+
+    // (data, byte count) of every array, in file order
+    vector<std::pair<const void*, size_t>> arrays = {
+        {offsets_.data(), 8 * offsets_.size()}, {neighbors_.data(), 8 * neighbors_.size()},
+        {weights_.data(), sizeof(Stored) * weights_.size()}, {in_offsets_.data(), 8 * in_offsets_.size()},
+        {in_neighbors_.data(), 8 * in_neighbors_.size()}, {in_weights_.data(), sizeof(Stored) * in_weights_.size()},
+        {vertices.data(), 8 * vertices.size()}
+    };
+
+    uint64_t h = 0;
+    for (const auto& a : arrays) h = checksumWords(h, a.first, a.second);
+    header.checksum = h;
+
+    std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const char padding[8] = {0};
+    for (const auto& a : arrays) {
+        if (a.second) out.write(static_cast<const char*>(a.first), std::streamsize(a.second));
+        if (a.second % 8) out.write(padding, std::streamsize(8 - a.second % 8));
+    }
+    return bool(out.flush());
+}
+
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::loadSnapshot(const string& file_name, bool verify_checksum, const string& source) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(file_name);
+    if (!file->is_open() || file->size() < sizeof(SnapshotHeader))
+        return false;
+
+    SnapshotHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION ||
+        header.endian_tag != SNAPSHOT_ENDIAN_TAG || header.weight_type != WeightTraits<Weight>::code)
+        return false;
+
+    // The text the snapshot was saved from must not have changed since
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!source.empty() && (!fileStamp(source, source_size, source_mtime) || source_size != header.source_size ||
+                            source_mtime != header.source_mtime))
+        return false;
+
+    // A Directed or Undirected Graph only takes a snapshot of the same shape
+    bool in_shared = header.flags & SNAPSHOT_IN_SHARED;
+    if (!Direction::runtime && in_shared != Direction::symmetric)
+        return false;
+
+    // Sizes must be consistent with each other and add up to exactly the file size
+    uint64_t n = header.num_nodes, m = header.num_edges;
+    uint64_t lengths[] = {n + 1, m, header.num_weights, in_shared ? 0 : n + 1, header.num_in_edges,
+                          header.num_in_weights, header.num_vertices};
+    if ((header.num_weights != 0 && header.num_weights != m) || (!in_shared && header.num_in_edges != m) ||
+        (header.num_in_weights != 0 && header.num_in_weights != header.num_in_edges) || (in_shared && header.num_in_edges != 0))
+        return false;
+    uint64_t word_lengths[] = {lengths[0], lengths[1], paddedWords(lengths[2], sizeof(Stored)), lengths[3], lengths[4],
+                               paddedWords(lengths[5], sizeof(Stored)), lengths[6]};
+    uint64_t words = 0;
+    for (uint64_t len : word_lengths) words += len;
+    if (words > (file->size() - sizeof(header)) / 8 || sizeof(header) + 8 * words != file->size())
+        return false;
+
+    // cheap sanity check on the row offsets, even without the checksum
+    const char* base = file->data() + sizeof(header);
+    uint64_t first_offset, last_offset;
+    std::memcpy(&first_offset, base, 8);
+    std::memcpy(&last_offset, base + 8 * n, 8);
+    if (first_offset != 0 || last_offset != m)
+        return false;
+    if (verify_checksum && checksumWords(0, base, 8 * words) != header.checksum)
+        return false;
+
+    // Where each array starts, in file order
+    const uint64_t* arrays[7];
+    const uint64_t* p = reinterpret_cast<const uint64_t*>(base);
+    for (int i = 0; i < 7; i++) {
+        arrays[i] = p;
+        p += word_lengths[i];
+    }
+
+    // Without the checksum, at least make sure no traversal can index out of bounds: both CSR indexes
+    // must be well formed, and every registered Vertex in the Graph
+    if (!verify_checksum) {
+        if (!validCsr(arrays[0], arrays[1], n, m) || (!in_shared && !validCsr(arrays[3], arrays[4], n, header.num_in_edges)))
+            return false;
+        for (uint64_t i = 0; i < header.num_vertices; ++i) {
+            if (arrays[6][i] >= n) return false;
+        }
+    }
+
+    // Point every array into the mapping; the Buffers share ownership of it
+    std::shared_ptr<const void> keep_alive = file;
+    offsets_ = Buffer<size_t>(reinterpret_cast<const size_t*>(arrays[0]), lengths[0], keep_alive);
+    neighbors_ = Buffer<Vertex>(reinterpret_cast<const Vertex*>(arrays[1]), lengths[1], keep_alive);
+    weights_ = Buffer<Stored>(reinterpret_cast<const Stored*>(arrays[2]), lengths[2], keep_alive);
+    in_offsets_ = Buffer<size_t>(reinterpret_cast<const size_t*>(arrays[3]), lengths[3], keep_alive);
+    in_neighbors_ = Buffer<Vertex>(reinterpret_cast<const Vertex*>(arrays[4]), lengths[4], keep_alive);
+    in_weights_ = Buffer<Stored>(reinterpret_cast<const Stored*>(arrays[5]), lengths[5], keep_alive);
+    vertices = Buffer<Vertex>(reinterpret_cast<const Vertex*>(arrays[6]), lengths[6], keep_alive);
+
+    is_double_directed = header.flags & SNAPSHOT_DOUBLE_DIRECTED;
+    in_shared_ = in_shared;
+    bits_ = BitMatrix();
+    return true;
 }
 
 /****************************** Complex Alg Functions ******************************/
@@ -141,7 +671,8 @@ std::ostream& operator<<(std::ostream& out, const Graph& g) {
 // Time complexity: O(b^d)
 // Space complexity: O(bd)
 // (b is breadth, d is depth)
-vector<int> Graph::iddfs(int start, int end, int max_depth) {
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::iddfs(int start, int end, int max_depth) {
     
     for (int i = 1; i < max_depth; i++) {
         // init the traversal, as well as a vector that is the reverse
@@ -157,27 +688,172 @@ vector<int> Graph::iddfs(int start, int end, int max_depth) {
     return vector<int>();
 }
 
-// recursively do the depth limited search
-bool Graph::dls(int start, int end, int limit, vector<int> &path) {
+// do the depth limited search: a DFS without visited marks, so every path of up to limit Edges is tried
+template <typename Weight, typename Direction>
+bool BasicGraph<Weight, Direction>::dls(int start, int end, int limit, vector<int> &path) {
+    struct DepthLimited : TraversalVisitor {
+        vector<int> stack;
+        int end, limit;
+        DepthLimited(int e, int l) : end(e), limit(l) {}
+        inline void onDiscover(Vertex v, Vertex, int) { stack.push_back(int(v)); }
+        // The Edge leaves the top of the stack, so it leads stack.size() Edges down. At the limit only end is
+        // worth stepping onto, which saves looking through the neighbors of every leaf just to turn back.
+        inline bool onEdge(Vertex, Vertex to) {
+            return int(stack.size()) < limit || (int(stack.size()) == limit && int(to) == end);
+        }
+        inline bool shouldStop(Vertex v) { return int(v) == end; }
+        inline void onFinish(Vertex) { stack.pop_back(); }
+    } visitor(end, limit);
 
-    // base case
-    if (start == end) {
-        path.push_back(start);
-        return true;
-    }
-    // stop if depth limit is reached
-    if (limit <= 0) return false;
+    if (!depthFirstFrom(start, [](Vertex, Vertex, int) { return true; }, visitor))
+        return false;
+    // the path goes in from end back to start, as the recursion used to unwind
+    path.insert(path.end(), visitor.stack.rbegin(), visitor.stack.rend());
+    return true;
+}
+
+template <typename Weight, typename Direction>
+vector<Vertex> BasicGraph<Weight, Direction>::boundedIddfs(Vertex start, Vertex end, int max_depth, size_t table_bytes) const {
+    size_t n = getSize();
+    if (start >= n || end >= n)
+        return vector<Vertex>();
+
+    const Vertex NONE = Vertex(-1);
+    struct Entry {
+        Vertex v;
+        int remaining;
+    };
+    size_t slots = std::min(n, table_bytes / sizeof(Entry));
+    vector<Entry> table(slots);
+    vector<uint64_t> on_path((n + 63) / 64, 0);
+    auto flip = [&on_path](Vertex v) { on_path[v >> 6] ^= uint64_t(1) << (v & 63); };
+
+    // the stack of (Vertex, next neighbor) frames is the current path
+    vector<std::pair<Vertex, size_t>> stack;
+    for (int limit = 1; limit < max_depth; limit++) {
+        std::fill(table.begin(), table.end(), Entry{NONE, -1});
+        bool cut_off = false;
+        stack.assign(1, std::make_pair(start, size_t(0)));
+        flip(start);
+        while (!stack.empty()) {
+            Vertex v = stack.back().first;
+            if (v == end) {
+                vector<Vertex> path;
+                for (const std::pair<Vertex, size_t>& frame : stack) path.push_back(frame.first);
+                return path;
+            }
+
+            int remaining = limit - int(stack.size() - 1);
+            Neighbors adj = neighbors(v);
+            size_t next = stack.back().second;
+            if (remaining == 0 && !adj.empty()) cut_off = true;
+            Vertex child = NONE;
+            while (remaining > 0 && next < adj.size()) {
+                Vertex u = adj[next++];
+                if ((on_path[u >> 6] >> (u & 63)) & 1) continue;
+                if (slots && table[u % slots].v == u && table[u % slots].remaining >= remaining - 1) continue;
+                child = u;
+                break;
+            }
 
-    // otherwise recurse through all connected vertices
-    vector<Graph::Edge> adj = getOutgoingEdges(start);
-    for (unsigned i = 0; i < adj.size(); i++) {
-        if (dls(adj[i].end, end, limit-1, path)) {
-            path.push_back(start);
-            return true;
+            if (child == NONE) {
+                // everything within remaining of v has been searched
+                if (slots) table[v % slots] = Entry{v, remaining};
+                flip(v);
+                stack.pop_back();
+            } else {
+                stack.back().second = next;
+                flip(child);
+                stack.emplace_back(child, 0);
+            }
         }
+        if (!cut_off)
+            break;
     }
+    return vector<Vertex>();
+}
 
-    return false;
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::parallelIddfs(int start, int end, int max_depth, ThreadPool& pool) const {
+    size_t n = getSize();
+    if (start < 0 || size_t(start) >= n || end < 0 || max_depth <= 1)
+        return vector<int>();
+    if (start == end)
+        return vector<int>(1, start);
+
+    const size_t NONE = size_t(-1);
+    // enough prefixes that a slow one near the end does not leave the other workers idle
+    const size_t wanted = 8 * size_t(pool.size());
+    vector<vector<uint64_t>> on_path(pool.size(), vector<uint64_t>((n + 63) / 64, 0));
+    vector<Vertex> prefixes, longer;
+    std::mutex found_lock;
+    vector<int> found;
+
+    for (int limit = 1; limit < max_depth; limit++) {
+        // prefixes holds paths of k Edges from start, back to back, in the order the sequential DFS reaches them
+        size_t k = 0;
+        prefixes.assign(1, Vertex(start));
+        while (int(k) < limit && prefixes.size() / (k + 1) < wanted) {
+            longer.clear();
+            for (size_t p = 0; p < prefixes.size(); p += k + 1) {
+                for (Vertex u : neighbors(prefixes[p + k])) {
+                    if (std::find(prefixes.begin() + p, prefixes.begin() + p + k + 1, u) != prefixes.begin() + p + k + 1) continue;
+                    longer.insert(longer.end(), prefixes.begin() + p, prefixes.begin() + p + k + 1);
+                    longer.push_back(u);
+                }
+            }
+            prefixes.swap(longer);
+            k++;
+        }
+        size_t tasks = prefixes.size() / (k + 1);
+
+        std::atomic<size_t> next_task(0), found_task(NONE);
+        pool.run([&](unsigned w) {
+            vector<uint64_t>& bits = on_path[w];
+            auto flip = [&bits](Vertex v) { bits[v >> 6] ^= uint64_t(1) << (v & 63); };
+            vector<std::pair<Vertex, size_t>> stack;
+            for (size_t t = next_task++; t < tasks && t < found_task.load(std::memory_order_relaxed); t = next_task++) {
+                const Vertex* prefix = &prefixes[t * (k + 1)];
+                for (size_t i = 0; i < k; ++i) flip(prefix[i]);
+                stack.assign(1, std::make_pair(prefix[k], size_t(0)));
+                flip(prefix[k]);
+
+                while (!stack.empty()) {
+                    // an earlier prefix found it: nothing from this one can come first
+                    if (found_task.load(std::memory_order_relaxed) < t) break;
+                    Vertex v = stack.back().first;
+                    if (int(v) == end) {
+                        std::lock_guard<std::mutex> lock(found_lock);
+                        if (t < found_task.load(std::memory_order_relaxed)) {
+                            found.assign(prefix, prefix + k);
+                            for (const std::pair<Vertex, size_t>& frame : stack) found.push_back(int(frame.first));
+                            found_task.store(t, std::memory_order_relaxed);
+                        }
+                        break;
+                    }
+                    int remaining = limit - int(k + stack.size() - 1);
+                    Neighbors adj = neighbors(v);
+                    size_t next = stack.back().second;
+                    while (remaining > 0 && next < adj.size() && ((bits[adj[next] >> 6] >> (adj[next] & 63)) & 1)) ++next;
+                    if (remaining <= 0 || next == adj.size()) {
+                        flip(v);
+                        stack.pop_back();
+                        continue;
+                    }
+                    stack.back().second = next + 1;
+                    flip(adj[next]);
+                    stack.emplace_back(adj[next], 0);
+                }
+
+                // leave the bitset clear for the next prefix
+                for (const std::pair<Vertex, size_t>& frame : stack) flip(frame.first);
+                for (size_t i = 0; i < k; ++i) flip(prefix[i]);
+            }
+        });
+        if (found_task.load() != NONE)
+            return found;
+    }
+    return vector<int>();
 }
 
 /****************************** Traversal Functions ******************************/
@@ -192,31 +868,519 @@ bool Graph::dls(int start, int end, int limit, vector<int> &path) {
  * returns array containing path from one node to the other
  */
 
-vector<int> Graph::BFS(int start, const Graph& g) {
-    // initialize values
-    vector<bool> visited(g.matrix_.size(), false);
-    vector<int> queue, traversal;
-    int vs;
+namespace {
 
-    // start queue and visited array
-    queue.push_back(start);
-    visited[start] = true;
+/**
+ * Visitor that ends a traversal once it reaches end
+ */
+struct StopAt : TraversalVisitor {
+    Vertex end;
+    explicit StopAt(Vertex e) : end(e) {}
+    inline bool shouldStop(Vertex v) { return v == end; }
+};
 
-    // execute BFS Algorithm
-    while (!queue.empty()) {
-        vs = queue[0];
-        traversal.push_back(vs);
-        queue.erase(queue.begin());
+}
+
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::BFS(int start, const BasicGraph& g) {
+    // a search for a Vertex that does not exist goes everywhere
+    return Search_BFS(start, -1, g);
+}
+
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::BFS(Vertex start, TraversalWorkspace& ws) const {
+    // a search for a Vertex that does not exist goes everywhere
+    return Search_BFS(start, TraversalWorkspace::NONE, ws);
+}
 
-        for (int i = 0; i < int(g.matrix_.size()); i++) {
-            if (g.matrix_[vs][i] == 1 && (!visited[i])) {
-                queue.push_back(i);
-                visited[i] = true;
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::directionOptimizingBFS(Vertex start, double alpha, double beta) const {
+    size_t n = getSize();
+    vector<int> depth(n, -1);
+    if (start >= n)
+        return depth;
+
+    size_t words = (n + 63) / 64;
+    vector<uint64_t> visited(words, 0), front_bits(words, 0), next_bits(words, 0);
+    vector<Vertex> frontier(1, start), next;
+    depth[start] = 0;
+    visited[start >> 6] |= uint64_t(1) << (start & 63);
+
+    // Edges out of the frontier, and Edges into the unvisited Vertices: what each direction would scan
+    size_t frontier_edges = getOutDegree(start), unvisited_edges = neighbors_.size() - getInDegree(start);
+    size_t frontier_size = 1, prev_size = 0;
+    bool bottom_up = false;
+
+    for (int level = 1; frontier_size > 0; level++) {
+        if (!bottom_up && frontier_edges > unvisited_edges / alpha) {
+            bottom_up = true;
+            std::fill(front_bits.begin(), front_bits.end(), 0);
+            for (Vertex v : frontier) front_bits[v >> 6] |= uint64_t(1) << (v & 63);
+        } else if (bottom_up && frontier_size < prev_size && frontier_size < n / beta) {
+            bottom_up = false;
+            frontier.clear();
+            for (size_t w = 0; w < words; w++) {
+                for (uint64_t bits = front_bits[w]; bits; bits &= bits - 1) frontier.push_back(64 * w + __builtin_ctzll(bits));
             }
         }
+
+        prev_size = frontier_size;
+        frontier_edges = frontier_size = 0;
+        if (bottom_up) {
+            // Every unvisited Vertex takes the first parent it finds in the frontier
+            std::fill(next_bits.begin(), next_bits.end(), 0);
+            for (size_t w = 0; w < words; w++) {
+                uint64_t unvisited = ~visited[w];
+                if (w == words - 1 && n % 64) unvisited &= (uint64_t(1) << (n % 64)) - 1;
+                for (; unvisited; unvisited &= unvisited - 1) {
+                    Vertex v = 64 * w + __builtin_ctzll(unvisited);
+                    for (Vertex u : inNeighbors(v)) {
+                        if (!(front_bits[u >> 6] >> (u & 63) & 1)) continue;
+                        depth[v] = level;
+                        next_bits[w] |= uint64_t(1) << (v & 63);
+                        frontier_size++;
+                        frontier_edges += getOutDegree(v);
+                        unvisited_edges -= getInDegree(v);
+                        break;
+                    }
+                }
+                visited[w] |= next_bits[w];
+            }
+            front_bits.swap(next_bits);
+        } else {
+            next.clear();
+            for (Vertex v : frontier) {
+                for (Vertex u : neighbors(v)) {
+                    if (visited[u >> 6] >> (u & 63) & 1) continue;
+                    visited[u >> 6] |= uint64_t(1) << (u & 63);
+                    depth[u] = level;
+                    next.push_back(u);
+                    frontier_edges += getOutDegree(u);
+                    unvisited_edges -= getInDegree(u);
+                }
+            }
+            frontier.swap(next);
+            frontier_size = frontier.size();
+        }
     }
 
-    return traversal;
+    return depth;
+}
+
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::parallelBFS(Vertex start, ThreadPool& pool, vector<int>& depth, bool deterministic) const {
+    size_t n = getSize();
+    depth.assign(n, -1);
+    vector<int> order;
+    if (start >= n)
+        return order;
+
+    // claim[v] is the rank (position in order) of the parent that got to v
+    const size_t NONE = size_t(-1);
+    std::unique_ptr<std::atomic<size_t>[]> claim(new std::atomic<size_t>[n]);
+    pool.parallelFor(n, [&claim, NONE](unsigned, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) claim[v].store(NONE, std::memory_order_relaxed);
+    });
+
+    // order holds every level back to back; the frontier is order[level_start, level_end)
+    order.resize(n);
+    order[0] = int(start);
+    depth[start] = 0;
+    claim[start].store(0, std::memory_order_relaxed);
+    size_t level_start = 0, level_end = 1;
+    vector<vector<std::pair<Vertex, size_t>>> next(pool.size());
+    vector<size_t> offsets(pool.size() + 1);
+
+    for (int level = 1; level_start < level_end; level++) {
+        // Expand: workers take contiguous slices of the frontier, in order, and claim unvisited neighbors.
+        // depth only changes between levels, so it can be read without synchronizing.
+        pool.parallelFor(level_end - level_start, [&](unsigned w, size_t begin, size_t end) {
+            vector<std::pair<Vertex, size_t>>& out = next[w];
+            out.clear();
+            for (size_t rank = level_start + begin; rank < level_start + end; ++rank) {
+                for (Vertex v : neighbors(order[rank])) {
+                    if (depth[v] != -1) continue;
+                    size_t seen = claim[v].load(std::memory_order_relaxed);
+                    if (deterministic) {
+                        while (rank < seen && !claim[v].compare_exchange_weak(seen, rank, std::memory_order_relaxed)) {}
+                        if (rank < seen) out.emplace_back(v, rank);
+                    } else if (seen == NONE && claim[v].compare_exchange_strong(seen, rank, std::memory_order_relaxed)) {
+                        out.emplace_back(v, rank);
+                    }
+                }
+            }
+        });
+
+        // Keep only the final claim on each Vertex. The slices were in order and so is each buffer,
+        // so the buffers back to back are the next level, in BFS order when deterministic.
+        pool.run([&](unsigned w) {
+            vector<std::pair<Vertex, size_t>>& out = next[w];
+            size_t kept = 0;
+            for (const std::pair<Vertex, size_t>& entry : out) {
+                if (claim[entry.first].load(std::memory_order_relaxed) == entry.second) out[kept++] = entry;
+            }
+            out.resize(kept);
+            for (const std::pair<Vertex, size_t>& entry : out) depth[entry.first] = level;
+        });
+
+        offsets[0] = level_end;
+        for (unsigned w = 0; w < pool.size(); ++w) offsets[w + 1] = offsets[w] + next[w].size();
+        pool.run([&](unsigned w) {
+            for (size_t i = 0; i < next[w].size(); ++i) order[offsets[w] + i] = int(next[w][i].first);
+        });
+        level_start = level_end;
+        level_end = offsets[pool.size()];
+    }
+
+    order.resize(level_end);
+    return order;
+}
+
+template <typename Weight, typename Direction>
+vector<Vertex> BasicGraph<Weight, Direction>::bidirectionalBFS(Vertex start, Vertex end) const {
+    TraversalWorkspace forward, backward;
+    return bidirectionalBFS(start, end, forward, backward);
+}
+
+template <typename Weight, typename Direction>
+vector<Vertex> BasicGraph<Weight, Direction>::bidirectionalBFS(Vertex start, Vertex end, TraversalWorkspace& forward, TraversalWorkspace& backward) const {
+    size_t n = getSize();
+    if (start >= n || end >= n)
+        return vector<Vertex>();
+    if (start == end)
+        return vector<Vertex>(1, start);
+
+    // side 0 searches forward from start, side 1 backward from end. Each queue holds every Vertex its side
+    // has reached, in order, and head[side] is where the current frontier starts.
+    TraversalWorkspace* ws[2] = {&forward, &backward};
+    forward.reset(n);
+    backward.reset(n);
+    forward.visit(start);
+    backward.visit(end);
+    forward.queue().assign(1, start);
+    backward.queue().assign(1, end);
+    size_t head[2] = {0, 0};
+
+    const Vertex NONE = TraversalWorkspace::NONE;
+    Vertex meet = NONE;
+    int best = -1;
+    while (meet == NONE && head[0] < forward.queue().size() && head[1] < backward.queue().size()) {
+        int side = forward.queue().size() - head[0] <= backward.queue().size() - head[1] ? 0 : 1;
+        TraversalWorkspace& self = *ws[side];
+        TraversalWorkspace& other = *ws[1 - side];
+        vector<Vertex>& queue = self.queue();
+        for (size_t level_end = queue.size(); head[side] < level_end; ++head[side]) {
+            Vertex v = queue[head[side]];
+            for (Vertex u : side == 0 ? neighbors(v) : inNeighbors(v)) {
+                if (!self.visit(u, v, self.distance(v) + 1)) continue;
+                queue.push_back(u);
+                // Meetings within one level can differ in length, so finish the level and keep the shortest
+                if (other.visited(u) && (best == -1 || self.distance(u) + other.distance(u) < best)) {
+                    best = self.distance(u) + other.distance(u);
+                    meet = u;
+                }
+            }
+        }
+    }
+    if (meet == NONE)
+        return vector<Vertex>();
+
+    vector<Vertex> path;
+    for (Vertex v = meet; v != NONE; v = forward.parent(v)) path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    for (Vertex v = backward.parent(meet); v != NONE; v = backward.parent(v)) path.push_back(v);
+    return path;
+}
+
+template <typename Weight, typename Direction>
+template <typename Visit>
+void BasicGraph<Weight, Direction>::msbfs(const vector<Vertex>& sources, Visit visit) const {
+    size_t n = getSize();
+    // bit i of seen[v] / frontier[v] / next[v] belongs to source batch + i
+    vector<uint64_t> seen(n), frontier(n), next(n, 0);
+    for (size_t batch = 0; batch < sources.size(); batch += 64) {
+        size_t count = std::min<size_t>(64, sources.size() - batch);
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(frontier.begin(), frontier.end(), 0);
+        bool active = false;
+        for (size_t i = 0; i < count; ++i) {
+            Vertex s = sources[batch + i];
+            if (s >= n) continue;
+            seen[s] |= uint64_t(1) << i;
+            frontier[s] |= uint64_t(1) << i;
+            visit(batch + i, s, 0);
+            active = true;
+        }
+
+        for (int level = 1; active; level++) {
+            for (Vertex v = 0; v < n; ++v) {
+                if (!frontier[v]) continue;
+                for (Vertex u : neighbors(v)) next[u] |= frontier[v];
+            }
+            active = false;
+            for (Vertex u = 0; u < n; ++u) {
+                uint64_t fresh = next[u] & ~seen[u];
+                next[u] = 0;
+                frontier[u] = fresh;
+                if (!fresh) continue;
+                seen[u] |= fresh;
+                active = true;
+                for (uint64_t bits = fresh; bits; bits &= bits - 1) visit(batch + __builtin_ctzll(bits), u, level);
+            }
+        }
+    }
+}
+
+template <typename Weight, typename Direction>
+vector<vector<int>> BasicGraph<Weight, Direction>::multiSourceBFS(const vector<Vertex>& sources) const {
+    vector<vector<int>> depth(sources.size(), vector<int>(getSize(), -1));
+    msbfs(sources, [&depth](size_t i, Vertex v, int level) { depth[i][v] = level; });
+    return depth;
+}
+
+template <typename Weight, typename Direction>
+vector<double> BasicGraph<Weight, Direction>::closeness(const vector<Vertex>& sources) const {
+    vector<size_t> reached(sources.size(), 0), total(sources.size(), 0);
+    msbfs(sources, [&reached, &total](size_t i, Vertex, int level) {
+        if (level == 0) return;
+        reached[i]++;
+        total[i] += level;
+    });
+    vector<double> result(sources.size(), 0);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (total[i]) result[i] = double(reached[i]) / double(total[i]);
+    }
+    return result;
+}
+
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::eccentricity(const vector<Vertex>& sources) const {
+    vector<int> result(sources.size(), -1);
+    // levels only grow, so the last one seen is the farthest
+    msbfs(sources, [&result](size_t i, Vertex, int level) { result[i] = level; });
+    return result;
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::kHopSearch(Vertex source, int k, TraversalWorkspace& ws) const {
+    ws.reset(getSize());
+    ws.queue().clear();
+    if (source >= getSize() || k < 0)
+        return;
+    TraversalVisitor visitor;
+    breadthFirst(source, ws, visitor, k);
+}
+
+template <typename Weight, typename Direction>
+vector<vector<Vertex>> BasicGraph<Weight, Direction>::kHopNeighborhood(Vertex source, int k, TraversalWorkspace& ws) const {
+    kHopSearch(source, k, ws);
+    vector<vector<Vertex>> hops(std::max(k + 1, 0));
+    for (Vertex v : ws.queue()) hops[ws.distance(v)].push_back(v);
+    return hops;
+}
+
+template <typename Weight, typename Direction>
+vector<vector<vector<Vertex>>> BasicGraph<Weight, Direction>::kHopNeighborhood(const vector<Vertex>& sources, int k, TraversalWorkspace& ws) const {
+    vector<vector<vector<Vertex>>> result;
+    result.reserve(sources.size());
+    for (Vertex source : sources) result.push_back(kHopNeighborhood(source, k, ws));
+    return result;
+}
+
+template <typename Weight, typename Direction>
+vector<size_t> BasicGraph<Weight, Direction>::kHopCounts(Vertex source, int k, TraversalWorkspace& ws) const {
+    kHopSearch(source, k, ws);
+    vector<size_t> counts(std::max(k + 1, 0), 0);
+    for (Vertex v : ws.queue()) counts[ws.distance(v)]++;
+    return counts;
+}
+
+template <typename Weight, typename Direction>
+vector<vector<size_t>> BasicGraph<Weight, Direction>::kHopCounts(const vector<Vertex>& sources, int k, TraversalWorkspace& ws) const {
+    vector<vector<size_t>> result;
+    result.reserve(sources.size());
+    for (Vertex source : sources) result.push_back(kHopCounts(source, k, ws));
+    return result;
+}
+
+namespace {
+    /**
+     * Writes every Vertex a BFS discovers into a ShortestPathTree
+     */
+    struct TreeBuilder : TraversalVisitor {
+        ShortestPathTree& tree;
+        explicit TreeBuilder(ShortestPathTree& tree) : tree(tree) {}
+        inline void onDiscover(Vertex v, Vertex parent, int depth) { tree.reach(v, parent, depth); }
+    };
+}
+
+template <typename Weight, typename Direction>
+ShortestPathTree BasicGraph<Weight, Direction>::shortestPathTree(Vertex source, TraversalWorkspace& ws) const {
+    ShortestPathTree tree(source, getSize());
+    ws.reset(getSize());
+    if (source >= getSize())
+        return tree;
+    TreeBuilder builder(tree);
+    breadthFirst(source, ws, builder);
+    return tree;
+}
+
+template <typename Weight, typename Direction>
+ShortestPathTree BasicGraph<Weight, Direction>::shortestPathTree(Vertex source) const {
+    TraversalWorkspace ws(getSize());
+    return shortestPathTree(source, ws);
+}
+
+template <typename Weight, typename Direction>
+ShortestPathTree BasicGraph<Weight, Direction>::dijkstra(Vertex source) const {
+    ShortestPathTree tree(source, getSize());
+    if (source >= getSize())
+        return tree;
+    tree.reach(source, ShortestPathTree::NONE, 0);
+    DaryHeap<> heap;
+    heap.push(0, source);
+    while (!heap.empty()) {
+        DaryHeap<>::Entry top = heap.top();
+        heap.pop();
+        // a Vertex is pushed again whenever its distance drops, so older entries are stale
+        if (top.key != tree.distance(top.vertex)) continue;
+        Neighbors adj = neighbors(top.vertex);
+        for (size_t i = 0; i < adj.size(); ++i) {
+            double weight = adj.weight(i);
+            if (!(weight >= 0)) continue;
+            double distance = top.key + weight;
+            if (distance < tree.distance(adj[i])) {
+                tree.reach(adj[i], top.vertex, distance);
+                heap.push(distance, adj[i]);
+            }
+        }
+    }
+    return tree;
+}
+
+template <typename Weight, typename Direction>
+ShortestPathTree BasicGraph<Weight, Direction>::deltaStepping(Vertex source, ThreadPool& pool, double delta) const {
+    size_t n = getSize();
+    ShortestPathTree tree(source, n);
+    if (source >= n)
+        return tree;
+
+    std::unique_ptr<std::atomic<double>[]> dist(new std::atomic<double>[n]);
+    vector<double> weight_sums(pool.size(), 0);
+    vector<size_t> edge_counts(pool.size(), 0);
+    pool.parallelFor(n, [&](unsigned w, size_t begin, size_t end) {
+        for (Vertex v = begin; v < end; ++v) {
+            dist[v].store(ShortestPathTree::infinity(), std::memory_order_relaxed);
+            if (delta > 0) continue;
+            Neighbors adj = neighbors(v);
+            for (size_t i = 0; i < adj.size(); ++i) {
+                if (!(adj.weight(i) >= 0)) continue;
+                weight_sums[w] += adj.weight(i);
+                edge_counts[w]++;
+            }
+        }
+    });
+    if (!(delta > 0)) {
+        double sum = 0;
+        size_t count = 0;
+        for (unsigned w = 0; w < pool.size(); ++w) {
+            sum += weight_sums[w];
+            count += edge_counts[w];
+        }
+        delta = count && sum > 0 ? sum / count : 1;
+    }
+
+    // A relaxation that lowered the distance of vertex to distance, through parent
+    struct Relaxation {
+        Vertex vertex, parent;
+        double distance;
+    };
+
+    // Lowers the distance of v to d if that is an improvement, and if so records it in out
+    auto relax = [&dist](Vertex v, Vertex parent, double d, vector<Relaxation>& out) {
+        double seen = dist[v].load(std::memory_order_relaxed);
+        while (d < seen) {
+            if (dist[v].compare_exchange_weak(seen, d, std::memory_order_relaxed)) {
+                out.push_back(Relaxation{v, parent, d});
+                return;
+            }
+        }
+    };
+
+    // Only the buckets that hold something are kept, keyed by floor(distance / delta), so a few huge
+    // weights cost a few buckets rather than every index up to the largest distance. The key stays a
+    // double: a distance can be far more than SIZE_MAX times delta. in_bucket[v] is the one bucket v
+    // counts in; entries left behind in other buckets are stale.
+    const double NONE = -1;
+    std::map<double, vector<Vertex>> buckets;
+    buckets[0].push_back(source);
+    vector<double> in_bucket(n, NONE), settled_in(n, NONE);
+    vector<vector<Relaxation>> next(pool.size());
+    dist[source].store(0, std::memory_order_relaxed);
+    tree.reach(source, ShortestPathTree::NONE, 0);
+    in_bucket[source] = 0;
+
+    // Moves the Vertices whose distance dropped into the bucket for their new distance, and into the tree
+    // through the relaxation that set it. Distances only drop, so each one is set by exactly one relaxation,
+    // and the tree gets a parent that produced its distance to the bit.
+    auto merge = [&]() {
+        for (vector<Relaxation>& out : next) {
+            for (const Relaxation& r : out) {
+                Vertex v = r.vertex;
+                double d = dist[v].load(std::memory_order_relaxed);
+                if (r.distance != d) continue;
+                tree.reach(v, r.parent, d);
+                // floor(d / delta); from 2^63 on every double is a whole number already
+                double b = d / delta;
+                if (b < 9.2e18) b = double(uint64_t(b));
+                if (in_bucket[v] == b) continue;
+                in_bucket[v] = b;
+                buckets[b].push_back(v);
+            }
+            out.clear();
+        }
+    };
+
+    // Relaxes the heavy (weight over delta) or light Edges out of every Vertex in from
+    auto expand = [&](const vector<Vertex>& from, bool heavy) {
+        pool.parallelFor(from.size(), [&](unsigned w, size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                Vertex u = from[k];
+                double du = dist[u].load(std::memory_order_relaxed);
+                Neighbors adj = neighbors(u);
+                for (size_t i = 0; i < adj.size(); ++i) {
+                    double weight = adj.weight(i);
+                    if (weight >= 0 && (weight > delta) == heavy) relax(adj[i], u, du + weight, next[w]);
+                }
+            }
+        });
+        merge();
+    };
+
+    // Always the lowest bucket next. Should rounding ever put a Vertex back into a bucket already done,
+    // it is simply processed again, so the distances are right whatever the bucketing.
+    vector<Vertex> frontier, settled;
+    while (!buckets.empty()) {
+        double i = buckets.begin()->first;
+        settled.clear();
+        // light Edges can lead back into bucket i, so keep going until it stays empty
+        for (auto bucket = buckets.begin(); bucket != buckets.end() && bucket->first == i; bucket = buckets.begin()) {
+            frontier.clear();
+            for (Vertex v : bucket->second) {
+                if (in_bucket[v] != i) continue;
+                in_bucket[v] = NONE;
+                frontier.push_back(v);
+                if (settled_in[v] != i) settled.push_back(v);
+                settled_in[v] = i;
+            }
+            buckets.erase(bucket);
+            expand(frontier, false);
+        }
+        // heavy Edges only reach later buckets, so once from the final distances is enough
+        expand(settled, true);
+    }
+
+    return tree;
 }
 
 /*
@@ -224,77 +1388,110 @@ vector<int> Graph::BFS(int start, const Graph& g) {
  * Also to avoid recursion problems the main array is passed through as a reference so the function doesn't return the array,
  * it just builds it through execution.
  */
-void Graph::DFS(int start, const Graph& g, vector<bool> &visited, vector<int> &dfsTraversal) {
-    // start visited and traversal array values
-    dfsTraversal.push_back(start);
-    visited[start] = true;
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::DFS(int start, const BasicGraph& g, vector<bool> &visited, vector<int> &dfsTraversal) {
+    // every Vertex goes in the traversal as it is reached
+    g.depthFirst(start, visited, [&dfsTraversal](Vertex v) {
+        dfsTraversal.push_back(int(v));
+        return false;
+    }, [](Vertex) {});
+}
 
-    // execute DFS recursive algorithm
-    for (int i = 0; i < int(g.matrix_.size()); i++) {
-        if (g.matrix_[start][i] == 1 && (!visited[i])) DFS(i, g, visited, dfsTraversal);
-    }
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::DFS(Vertex start, TraversalWorkspace& ws) const {
+    // a search for a Vertex that does not exist goes everywhere
+    return Search_DFS(start, TraversalWorkspace::NONE, ws);
 }
 
 /****************************** Basic Search Functions ******************************/
 
-vector<int> Graph::Search_BFS(int start, int end, const Graph& g) {
-    // same as the BFS() code initially
-    vector<bool> visited(g.matrix_.size(), false);
-    vector<int> queue, traversal;
-    int vs;
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::Search_BFS(int start, int end, const BasicGraph& g) {
+    // The traversal doubles as the queue: Vertices come out in the order they went in, so popping
+    // is moving the head cursor forward, and stopping at end leaves exactly the Vertices visited so far
+    if (g.hasBitMatrix())
+        return g.bitMatrixSearch(start, end);
 
-    queue.push_back(start);
+    vector<int> traversal;
+    vector<bool> visited(g.getSize(), false);
     visited[start] = true;
+    StopAt visitor = StopAt(Vertex(end));
+    g.breadthFirstFrom(start, traversal, [&visited](Vertex u, Vertex, int) {
+        if (visited[u]) return false;
+        visited[u] = true;
+        return true;
+    }, visitor);
+    return traversal;
+}
 
-    while (!queue.empty()) {
-        vs = queue[0];
-        traversal.push_back(vs);
-
-        // check if the BFS algorithm has found the target and return that path if it has
-        if (vs == end) return traversal;
-
-        queue.erase(queue.begin());
-
-        for (int i = 0; i < int(g.matrix_.size()); i++) {
-            if (g.matrix_[vs][i] == 1 && (!visited[i])) {
-                queue.push_back(i);
-                visited[i] = true;
-            }
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::bitMatrixSearch(int start, int end) const {
+    vector<int> traversal(1, start);
+    vector<uint64_t> visited_bits(bits_.wordsPerRow(), 0);
+    visited_bits[start >> 6] |= uint64_t(1) << (start & 63);
+    for (size_t head = 0; head < traversal.size(); ++head) {
+        int vs = traversal[head];
+        if (vs == end) {
+            traversal.resize(head + 1);
+            break;
         }
+        // the unvisited neighbors are row AND NOT visited, 64 at a time
+        bits_.expand(vs, visited_bits.data(), [&traversal](size_t i) { traversal.push_back(i); });
     }
-
-    // if value isn't found just return the full traversal of graph
     return traversal;
 }
 
-void Graph::Search_DFS(int start, int end, const Graph& g, vector<bool> &visited, vector<int> &dfsTraversal) {
-    // check if target value has been found and added in array to make sure that it doesn't go further recursively if it has
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::Search_BFS(Vertex start, Vertex end, TraversalWorkspace& ws) const {
+    ws.reset(getSize());
+    if (start >= getSize())
+        return vector<int>();
+    StopAt visitor(end);
+    breadthFirst(start, ws, visitor);
+    return vector<int>(ws.queue().begin(), ws.queue().end());
+}
+
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::Search_DFS(int start, int end, const BasicGraph& g, vector<bool> &visited, vector<int> &dfsTraversal) {
+    // check if target value has already been found by an earlier search
     if(find(dfsTraversal.begin(), dfsTraversal.end(), end) != dfsTraversal.end()) return;
 
-    // same as DFS() for the most part
-    dfsTraversal.push_back(start);
-    visited[start] = true;
-    if (start == end) return;
-    for (int i = 0; i < int(g.matrix_.size()); i++) {
-        // add condition that checks if the target has been found to prevent unnecessary recursion
-        if (g.matrix_[start][i] == 1 && (!visited[i]) && start != end) Search_DFS(i, end, g, visited, dfsTraversal);
-    }
+    // same as DFS(), stopping as soon as the target is reached
+    g.depthFirst(start, visited, [&dfsTraversal, end](Vertex v) {
+        dfsTraversal.push_back(int(v));
+        return int(v) == end;
+    }, [](Vertex) {});
+}
+
+template <typename Weight, typename Direction>
+vector<int> BasicGraph<Weight, Direction>::Search_DFS(Vertex start, Vertex end, TraversalWorkspace& ws) const {
+    ws.reset(getSize());
+    vector<int> traversal;
+    if (start >= getSize())
+        return traversal;
+    depthFirst(start, ws, [&traversal, end](Vertex v) {
+        traversal.push_back(int(v));
+        return v == end;
+    }, [](Vertex) {});
+    return traversal;
 }
 
 /****************************** Shortest Path Alg Functions ******************************/
 
-vector<vector<double>> Graph::FloydWarshall() {
+template <typename Weight, typename Direction>
+vector<vector<double>> BasicGraph<Weight, Direction>::FloydWarshall() {
     int INFINITY = __INT_MAX__, num_vertices = getSize(), n = num_vertices;
     vector<vector<double>> floyd_warsh_matrix(n, vector<double>(n, 0.0));
     
     // Initialize adjacency matrix to +inf and set diagonal to 0.0 
     for (int i = 0; i < num_vertices; i++) {
         for (int j = 0; j < num_vertices; j++) {
-            // Check if there is a connection (All edge weights = 1. No further calculations needed)
-            if (matrix_[i][j] == 1) floyd_warsh_matrix[i][j] = matrix_[i][j];
-            else if (i == j) floyd_warsh_matrix[i][j] = 0.0; // Check if vertex points to self (e.g. Vertex A to Vertex A)
+            if (i == j) floyd_warsh_matrix[i][j] = 0.0; // Check if vertex points to self (e.g. Vertex A to Vertex A)
             else floyd_warsh_matrix[i][j] = INFINITY; // Set pairs with no relationship to infinity
         }
+        // Fill in the connections, straight from the CSR row
+        Neighbors adj = neighbors(i);
+        for (size_t k = 0; k < adj.size(); k++) floyd_warsh_matrix[i][adj[k]] = adj.weight(k);
     }
 
     // The meat of the Floyd Warshall Algorithm
@@ -310,7 +1507,8 @@ vector<vector<double>> Graph::FloydWarshall() {
     return floyd_warsh_matrix; 
 }
 
-void Graph::print_shortest_paths(const vector<vector<double>> fw_matrix, bool double_directed) {
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::print_shortest_paths(const vector<vector<double>> fw_matrix, bool double_directed) {
     double smallest = find_min_max_paths(fw_matrix)[0];
 
     // Compile all relationships that have the min path length
@@ -343,7 +1541,8 @@ void Graph::print_shortest_paths(const vector<vector<double>> fw_matrix, bool do
     for (unsigned i = 0; i < lim; i++) cout << shortest_paths[i] << endl;
 }
 
-void Graph::print_longest_paths(const vector<vector<double>> fw_matrix, bool double_directed) {
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::print_longest_paths(const vector<vector<double>> fw_matrix, bool double_directed) {
     double longest = find_min_max_paths(fw_matrix)[1];
 
     // Compile all relationships that have the max path length
@@ -376,7 +1575,8 @@ void Graph::print_longest_paths(const vector<vector<double>> fw_matrix, bool dou
         cout << longest_paths[i] << endl;
 }
 
-vector<double> Graph::find_min_max_paths(const vector<vector<double>> matrix) {
+template <typename Weight, typename Direction>
+vector<double> BasicGraph<Weight, Direction>::find_min_max_paths(const vector<vector<double>> matrix) {
     // First find smallest and longest path length
     double smallest = __INT_MAX__, longest = 0.0;
 
@@ -393,7 +1593,8 @@ vector<double> Graph::find_min_max_paths(const vector<vector<double>> matrix) {
 }
 
 /*************************** I/O Driver Code ***************************/
-void Graph::start_presentation(bool is_full_dataset) {
+template <typename Weight, typename Direction>
+void BasicGraph<Weight, Direction>::start_presentation(bool is_full_dataset) {
     vector<string> lines;
     cout << "We examined a dataset of social circles on Facebook" << endl;
     Current_State current_state = Current_State::MENU;
@@ -492,10 +1693,8 @@ void Graph::start_presentation(bool is_full_dataset) {
                 cout << "Type in the number: ";
 
                 // initialize required variables
-                vector<int> path, traversal;
                 int selector, start = -1;
-                vector<bool> visited;
-	            for (size_t i = 0; i < this->getSize(); i++) visited.push_back(false);
+                TraversalWorkspace workspace(this->getSize());
 
                 // choose traversal
                 cin >> selector;
@@ -522,7 +1721,7 @@ void Graph::start_presentation(bool is_full_dataset) {
                         cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         start = -1;
                     }
-                    if (this->getOutgoingEdges(start).size() == 0) {
+                    if (this->getOutDegree(start) == 0) {
                         cout << endl << "Sorry, that vertex doesn't exist. Try again." << endl << endl;
                         start = -1;
                     }
@@ -530,16 +1729,15 @@ void Graph::start_presentation(bool is_full_dataset) {
 
                 // perform traversals based on selector
                 switch(selector) {
+                    // printed as the traversal goes, instead of after it is done
                     case 1:
-                        path = this->BFS(start, * this);
                         cout << endl << "BFS Traversal produces: " << endl;
-                        for(unsigned i : path) cout << i << " ";
+                        for (const TraversalStep& step : this->bfsRange(start, workspace)) cout << step.vertex << " ";
                         cout << endl;
                         break;
                     case 2:
-                        this->DFS(start, * this, visited, traversal);
                         cout << endl << "DFS Traversal produces: " << endl;
-                        for(unsigned i : traversal) cout << i << " ";
+                        for (const TraversalStep& step : this->dfsRange(start, workspace)) cout << step.vertex << " ";
                         cout << endl;
                         break;
                     default:
@@ -608,7 +1806,7 @@ void Graph::start_presentation(bool is_full_dataset) {
                         cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         start = -1;
                     }
-                    if (this->getOutgoingEdges(start).size() == 0) {
+                    if (this->getOutDegree(start) == 0) {
                         cout << endl << "Sorry, that vertex doesn't exist. Try Again. " << endl << endl;
                         start = -1;
                     }
@@ -623,7 +1821,7 @@ void Graph::start_presentation(bool is_full_dataset) {
                         cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         end = -1;
                     }
-                    if (this->getOutgoingEdges(end).size() == 0) {
+                    if (this->getOutDegree(end) == 0) {
                         cout << endl << "Sorry, that vertex doesn't exist. Try Again. " << endl << endl;
                         end = -1;
                     }
@@ -653,8 +1851,7 @@ void Graph::start_presentation(bool is_full_dataset) {
 
                 // INITIALIZING VARIABLES FOR TRAVERSALS
                 vector<int> path, traversal;
-                vector<bool> visited;
-                for (size_t i = 0; i < this->getSize(); i++) visited.push_back(false);
+                TraversalWorkspace workspace(this->getSize());
 
                 // calculate time function takes for BFS
                 cout << "Time to run BFS: ";
@@ -664,10 +1861,18 @@ void Graph::start_presentation(bool is_full_dataset) {
                 auto duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
                 cout << duration << " microseconds" << endl;
 
+                // calculate time function takes for the direction-optimizing BFS
+                cout << "Time to run direction-optimizing BFS: ";
+                t1 = std::chrono::high_resolution_clock::now();
+                this->directionOptimizingBFS(0);
+                t2 = std::chrono::high_resolution_clock::now();
+                duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
+                cout << duration << " microseconds" << endl;
+
                 // calculate time function take for DFS
                 cout << "Time to run DFS: ";
                 t1 = std::chrono::high_resolution_clock::now();
-                this->DFS(0, * this, visited, traversal);
+                traversal = this->DFS(0, workspace);
                 t2 = std::chrono::high_resolution_clock::now();
                 duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
                 cout << duration << " microseconds" << endl;
@@ -690,7 +1895,7 @@ void Graph::start_presentation(bool is_full_dataset) {
                         cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         start = -1;
                     }
-                    if (this->getOutgoingEdges(start).size() == 0) {
+                    if (this->getOutDegree(start) == 0) {
                         cout << endl << "Sorry, that vertex doesn't exist. Try Again. " << endl << endl;
                         start = -1;
                     }
@@ -706,7 +1911,7 @@ void Graph::start_presentation(bool is_full_dataset) {
                         cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         end = -1;
                     }
-                    if (this->getOutgoingEdges(end).size() == 0) {
+                    if (this->getOutDegree(end) == 0) {
                         cout << endl << "Sorry, that vertex doesn't exist. Try Again. " << endl << endl;
                         end = -1;
                     }
@@ -723,7 +1928,7 @@ void Graph::start_presentation(bool is_full_dataset) {
                 // calculate time function take for DFS Search
                 cout << "Time to run DFS Search: ";
                 t1 = std::chrono::high_resolution_clock::now();
-                this->Search_DFS(start, end, * this, visited, traversal);
+                traversal = this->Search_DFS(start, end, workspace);
                 t2 = std::chrono::high_resolution_clock::now();
                 duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
                 cout << duration << " microseconds" << endl;
@@ -734,6 +1939,14 @@ void Graph::start_presentation(bool is_full_dataset) {
                 vector<int> trav = iddfs(start, end, 8);
                 t2 = std::chrono::high_resolution_clock::now();
                 duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
+                cout << duration << " microseconds" << endl;
+
+                // calculate time function take for IDDFS with cycle pruning and a 1 MB transposition table
+                cout << "Time to run memory-bounded IDDFS: ";
+                t1 = std::chrono::high_resolution_clock::now();
+                this->boundedIddfs(start, end, 8, 1 << 20);
+                t2 = std::chrono::high_resolution_clock::now();
+                duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
                 cout << duration << " microseconds" << endl << endl;
                 break;
             }
@@ -748,4 +1961,8 @@ void Graph::start_presentation(bool is_full_dataset) {
         cout << "**********************************" << endl;
         cout << "*    Thank you for your time!    *" << endl;
         cout << "**********************************" << endl;
-}
\ No newline at end of file
+}
+
+#define DEFINE_BASIC_GRAPH(W, D) template class BasicGraph<W, D>;
+FOR_EACH_BASIC_GRAPH(DEFINE_BASIC_GRAPH)
+#undef DEFINE_BASIC_GRAPH
@@ -6,6 +6,14 @@
 #include <iostream>
 #include <list>
 #include <iterator>
+#include <cstdint>
+
+#include "BitMatrix.h"
+#include "Buffer.h"
+#include "IdMap.h"
+#include "ShortestPathTree.h"
+#include "TraversalRange.h"
+#include "TraversalWorkspace.h"
 
 using std::string;
 using std::vector;
@@ -13,8 +21,207 @@ using namespace std;
 
 typedef size_t Vertex;
 
-/** A simple directed graph, implemented via an Adjacency Matrix. */
-class Graph {
+class ThreadPool;
+
+/**
+ * Simple struct to contain the Edges. Weights are given as doubles, whatever type a Graph stores them as.
+ */
+struct Edge {
+    /**
+     * Vertex which this Edge starts from
+     */
+    Vertex start;
+
+    /**
+     * Vertex which this Edge ends at
+     */
+    Vertex end;
+
+    /**
+     * Weight of this Edge. Default of 1.0.
+     */
+    double weight;
+
+    /**
+     * Construct a new Edge object
+     * 
+     * @param s Starting vertex
+     * @param e Ending vertex
+     */
+    Edge(Vertex s, Vertex e) : start(s), end(e), weight(1.0) {}
+    /**
+     * @brief Construct a new Edge object
+     * 
+     * @param s Starting vertex
+     * @param e Ending vertex
+     * @param w Weight of Edge
+     */
+    Edge(Vertex s, Vertex e, double w) : start(s), end(e), weight(w) {}
+    /**
+     * @brief Construct a new Edge object
+     * 
+     * @param s String representation of starting Vertex
+     * @param e String representation of ending Vertex
+     */
+    Edge(string s, string e) : start(std::stoull(s)), end(std::stoull(e)), weight(1.0) {}
+    /**
+     * @brief Construct a new Edge object
+     * 
+     * @param s String representation of starting Vertex
+     * @param e String representation of ending Vertex
+     * @param w Weight of Edge
+     */
+    Edge(string s, string e, double w) : start(std::stoull(s)), end(std::stoull(e)), weight(w) {}
+
+    /**
+     * Determines which Vertex, start or end, has greater magnitude
+     * 
+     * @return Vertex of this Edge with greater index magnitude 
+     */
+    Vertex maxVertex() const { if (start >= end) return start; else return end; }
+
+    /**
+     * Insertion operator for output
+     * 
+     * @param out ostream ref for operator chaining
+     * @param e edge to insert
+     * @return std::ostream& for operator chaining
+     */
+    friend std::ostream& operator<<(std::ostream& out, const Edge& e) {
+        out << "{" << e.start << ", " << e.end << " : " << e.weight << "}";
+        return out;
+    }
+    
+    friend bool operator==(const Edge& a, const Edge& b) {
+        return a.start == b.start && a.end == b.end && a.weight == b.weight;   
+    }
+};
+
+/**
+ * Hooks for BasicGraph::breadthFirst and depthFirst, with do-nothing defaults. A visitor derives from
+ * this and hides the hooks it needs; the traversal is a template on the visitor type, so they are
+ * resolved at compile time and inlined, with no virtual calls.
+ */
+struct TraversalVisitor {
+    /**
+     * @brief v has just been reached from parent (TraversalWorkspace::NONE for the start), depth Edges from the start
+     */
+    inline void onDiscover(Vertex, Vertex, int) {}
+
+    /**
+     * @brief The Edge from, to is being looked at. Returning false skips it, as if it were not there.
+     */
+    inline bool onEdge(Vertex, Vertex) { return true; }
+
+    /**
+     * @brief Asked right after v is discovered. Returning true ends the traversal there.
+     */
+    inline bool shouldStop(Vertex) { return false; }
+
+    /**
+     * @brief Every Edge out of v has been looked at (for a DFS, every Vertex reached through v is done too)
+     */
+    inline void onFinish(Vertex) {}
+};
+
+/**
+ * Directedness policies for BasicGraph. Directed stores each Edge one way, Undirected stores each
+ * Edge both ways (and changeWeight keeps it that way, so the incoming index is never needed), and
+ * RuntimeDirected decides at construction, from the double_directed flag, like Graph always has.
+ */
+struct Directed { static const bool runtime = false, symmetric = false; };
+struct Undirected { static const bool runtime = false, symmetric = true; };
+struct RuntimeDirected { static const bool runtime = true, symmetric = false; };
+
+/**
+ * How a BasicGraph stores its weights: the Stored element type, whether weights are stored at all,
+ * store() to convert a double weight (a stored 0 means there is no Edge), and a code identifying
+ * the type in snapshots. Specialized for bool (unweighted: nothing stored, every Edge weighs 1),
+ * uint8_t (clamped to 0..255), float and double.
+ */
+template <typename Weight>
+struct WeightTraits;
+
+template <>
+struct WeightTraits<bool> {
+    typedef uint8_t Stored;
+    static const bool weighted = false;
+    static const uint32_t code = 1;
+    static Stored store(double w) { return w != 0; }
+};
+
+template <>
+struct WeightTraits<uint8_t> {
+    typedef uint8_t Stored;
+    static const bool weighted = true;
+    static const uint32_t code = 2;
+    static Stored store(double w) { return w <= 0 ? 0 : w >= 255 ? 255 : Stored(w); }
+};
+
+template <>
+struct WeightTraits<float> {
+    typedef float Stored;
+    static const bool weighted = true;
+    static const uint32_t code = 3;
+    static Stored store(double w) { return Stored(w); }
+};
+
+template <>
+struct WeightTraits<double> {
+    typedef double Stored;
+    static const bool weighted = true;
+    static const uint32_t code = 4;
+    static Stored store(double w) { return w; }
+};
+
+/**
+ * Non-owning view of one CSR row: the neighbor ids of a Vertex, sorted ascending, and their weights.
+ * Costs two pointers to make and nothing to iterate; range-for gives the neighbor ids. Only valid
+ * until the Graph it came from is changed.
+ */
+template <typename Stored>
+class NeighborRange {
+    public:
+        /**
+         * @brief Construct a view of count neighbors
+         * 
+         * @param ids First neighbor id
+         * @param weights Their weights, or nullptr if every weight is 1.0
+         * @param count Number of neighbors
+         */
+        NeighborRange(const Vertex* ids, const Stored* weights, size_t count) : ids_(ids), weights_(weights), count_(count) {}
+
+        inline const Vertex* begin() const { return ids_; }
+        inline const Vertex* end() const { return ids_ + count_; }
+        inline size_t size() const { return count_; }
+        inline bool empty() const { return count_ == 0; }
+
+        /**
+         * @brief Id of the i-th neighbor
+         */
+        inline Vertex operator[](size_t i) const { return ids_[i]; }
+
+        /**
+         * @brief Weight of the Edge to the i-th neighbor
+         */
+        inline double weight(size_t i) const { return weights_ ? double(weights_[i]) : 1.0; }
+
+    private:
+        const Vertex* ids_;
+        const Stored* weights_;
+        size_t count_;
+};
+
+/**
+ * A simple directed graph, implemented via Compressed Sparse Row (CSR) adjacency lists. Weight is the
+ * stored weight type and Direction one of the policies above, both fixed at compile time, so e.g.
+ * BasicGraph<bool, Undirected> stores no weights at all and never checks for an incoming index.
+ * Graph is the double weighted, runtime directed instantiation every tool uses by default.
+ */
+template <typename Weight, typename Direction>
+class BasicGraph {
+    typedef typename WeightTraits<Weight>::Stored Stored;
+
     enum class Current_State {
         MENU = 1,
         STRUCTURE = 2,
@@ -24,80 +231,23 @@ class Graph {
         TIMECOMPLEXITY = 6,
         QUIT = 7
     };
+    friend class Reorder;
+
     public:
         /**
-         * Simple struct to contain the Edges.
-         */
-        struct Edge {
-            /**
-             * Vertex which this Edge starts from
-             */
-            Vertex start;
-
-            /**
-             * Vertex which this Edge ends at
-             */
-            Vertex end;
-
-            /**
-             * Weight of this Edge. Default of 1.0.
-             */
-            double weight;
-
-            /**
-             * Construct a new Edge object
-             * 
-             * @param s Starting vertex
-             * @param e Ending vertex
-             */
-            Edge(Vertex s, Vertex e) : start(s), end(e), weight(1.0) {}
-            /**
-             * @brief Construct a new Edge object
-             * 
-             * @param s Starting vertex
-             * @param e Ending vertex
-             * @param w Weight of Edge
-             */
-            Edge(Vertex s, Vertex e, double w) : start(s), end(e), weight(w) {}
-            /**
-             * @brief Construct a new Edge object
-             * 
-             * @param s String representation of starting Vertex
-             * @param e String representation of ending Vertex
-             */
-            Edge(string s, string e) : start(std::stoi(s)), end(std::stoi(e)), weight(1.0) {}
-            /**
-             * @brief Construct a new Edge object
-             * 
-             * @param s String representation of starting Vertex
-             * @param e String representation of ending Vertex
-             * @param w Weight of Edge
-             */
-            Edge(string s, string e, double w) : start(std::stoi(s)), end(std::stoi(e)), weight(w) {}
-
-            /**
-             * Determines which Vertex, start or end, has greater magnitude
-             * 
-             * @return Vertex of this Edge with greater index magnitude 
-             */
-            Vertex maxVertex() const { if (start >= end) return start; else return end; }
-
-            /**
-             * Insertion operator for output
-             * 
-             * @param out ostream ref for operator chaining
-             * @param e edge to insert
-             * @return std::ostream& for operator chaining
-             */
-            friend std::ostream& operator<<(std::ostream& out, const Edge& e) {
-                out << "{" << e.start << ", " << e.end << " : " << e.weight << "}";
-                return out;
-            }
-            
-            friend bool operator==(const Edge& a, const Edge& b) {
-                return a.start == b.start && a.end == b.end && a.weight == b.weight;   
-            }
-        };
+         * Edges are shared by every BasicGraph, see ::Edge
+         */
+        typedef ::Edge Edge;
+
+        /**
+         * View of the neighbors of a Vertex, see neighbors()
+         */
+        typedef NeighborRange<Stored> Neighbors;
+
+        /**
+         * @brief Construct an empty Graph, with no Vertices. Mostly useful as a target for loadSnapshot().
+         */
+        BasicGraph();
 
         /**
          * @brief Construct a new Graph object
@@ -109,7 +259,18 @@ class Graph {
          * reverse edges for all connections given (i.e. for 0->2 and 1->3, the Graph will add
          * 2->0 and 3->1 edges also. If false, no change to default behavior).
          */
-        Graph(const vector<string>& lines, bool double_directed);
+        BasicGraph(const vector<string>& lines, bool double_directed);
+
+        /**
+         * @brief Construct a new Graph object from already parsed ids, e.g. from FileReader::fileToIds
+         * 
+         * @param ids Flat id list, same layout as lines above: ids[2i] -> ids[2i + 1] is an Edge.
+         * The Graph has max id + 1 Vertices, so run sparse or huge ids (10^9, 64-bit hashes) through
+         * IdMap::compact() first.
+         * @param double_directed Boolean flag. If true, the graph will create corresponding
+         * reverse edges for all connections given.
+         */
+        BasicGraph(const vector<uint64_t>& ids, bool double_directed);
 
         /**
          * @brief Construct a new Graph object
@@ -120,7 +281,36 @@ class Graph {
          * reverse edges for all connections given (i.e. for 0->2 and 1->3, the Graph will add
          * 2->0 and 3->1 edges also. If false, no change to default behavior).
          */
-        Graph(const vector<Edge>& edges, size_t num_nodes, bool double_directed);
+        BasicGraph(const vector<Edge>& edges, size_t num_nodes, bool double_directed);
+
+        /**
+         * @brief Writes the Graph to a versioned binary snapshot: a fixed header (magic, version, flags,
+         * array lengths, checksum) followed by the raw CSR arrays - offsets, neighbors, weights, the
+         * incoming index and the registered vertices - each 8-byte aligned. The bit matrix is not saved.
+         * 
+         * @param file_name Path to write to
+         * @param source Text file the Graph was parsed from, if any. Its size and modification time are
+         * recorded, so loadSnapshot() can tell when the snapshot is out of date.
+         * @return true if the whole snapshot was written
+         */
+        bool saveSnapshot(const string& file_name, const string& source = "") const;
+
+        /**
+         * @brief Replaces this Graph with a snapshot written by saveSnapshot(). The file is memory mapped and
+         * the CSR arrays point straight into the mapping, so there is nothing to deserialize: the Graph is
+         * queryable as soon as the header is checked. The mapping lives as long as the Graph (or any copy of it)
+         * does; changeWeight() copies the arrays it edits out of the mapping first.
+         * 
+         * @param file_name Path of the snapshot
+         * @param verify_checksum If true, reads the whole file once to check it is not corrupted. If false, the
+         * data is only checked to be a well-formed Graph (offsets in order, every id in range), in one pass
+         * over the index arrays that skips the weights.
+         * @param source If given, the text file the snapshot should have been saved from. It must still have
+         * the size and modification time saveSnapshot() recorded, otherwise it has changed since.
+         * @return true if loaded; false (leaving this Graph unchanged) if the file is missing, from
+         * another version or machine, truncated, fails the checksum, or is older than source
+         */
+        bool loadSnapshot(const string& file_name, bool verify_checksum = true, const string& source = "");
 
         /**
          * @brief Changes the weight of the Edge with e's start and end to the weight in e
@@ -130,8 +320,9 @@ class Graph {
         void changeWeight(const Edge& e);
         
         /**
-         * @brief Changes the weight of the Edge from start to end. Directional!
-         * Can also be used to create new Edges.
+         * @brief Changes the weight of the Edge from start to end. Directional, except on an Undirected
+         * Graph, where the Edge from end to start changes with it. Can also be used to create new Edges.
+         * The weight is converted to the stored Weight type; a weight that converts to 0 removes the Edge.
          * 
          * @param start Starting Vertex of edge to set
          * @param end Ending Vertex of edge to set
@@ -174,7 +365,7 @@ class Graph {
         double getWeight(Vertex start, Vertex end) const;
         
         /**
-         * @brief Get the outgoing edges FROM a Vertex
+         * @brief Get the outgoing edges FROM a Vertex. Copies them into a new vector; see neighbors()
          * 
          * @param start Vertex to check 
          * @return vector<Edge> of all outgoing Edges from Start if it exists, else empty vector
@@ -189,12 +380,126 @@ class Graph {
          */
         vector<Edge> getIncomingEdges(Vertex end) const;
 
+        /**
+         * @brief Get the Vertices start has an Edge to, and the weights of those Edges, without copying
+         * anything. Prefer it over getOutgoingEdges() in loops.
+         * 
+         * @param start Vertex to check
+         * @return Neighbors View of the outgoing Edges, empty if start does not exist
+         */
+        inline Neighbors neighbors(Vertex start) const {
+            if (start >= getSize()) return Neighbors(nullptr, nullptr, 0);
+            return Neighbors(neighbors_.data() + offsets_[start], weights_.empty() ? nullptr : weights_.data() + offsets_[start],
+                             offsets_[start + 1] - offsets_[start]);
+        }
+
+        /**
+         * @brief Get the Vertices with an Edge to end, and the weights of those Edges, without copying anything
+         * 
+         * @param end Vertex to check
+         * @return Neighbors View of the incoming Edges, empty if end does not exist
+         */
+        inline Neighbors inNeighbors(Vertex end) const {
+            if (inShared()) return neighbors(end);
+            if (end >= getSize()) return Neighbors(nullptr, nullptr, 0);
+            return Neighbors(in_neighbors_.data() + in_offsets_[end], in_weights_.empty() ? nullptr : in_weights_.data() + in_offsets_[end],
+                             in_offsets_[end + 1] - in_offsets_[end]);
+        }
+
+        /**
+         * @brief Get the number of Edges leaving a Vertex
+         * 
+         * @param start Vertex to check
+         * @return size_t Out-degree of start, or 0 if it does not exist
+         */
+        inline size_t getOutDegree(Vertex start) const { return start < getSize() ? offsets_[start + 1] - offsets_[start] : 0; }
+
+        /**
+         * @brief Get the number of Edges arriving at a Vertex
+         * 
+         * @param end Vertex to check
+         * @return size_t In-degree of end, or 0 if it does not exist
+         */
+        inline size_t getInDegree(Vertex end) const {
+            if (end >= getSize()) return 0;
+            return inShared() ? offsets_[end + 1] - offsets_[end] : in_offsets_[end + 1] - in_offsets_[end];
+        }
+
+        /**
+         * @brief Builds the bit-packed adjacency matrix (one bit per cell) alongside the CSR arrays, which
+         * switches BFS, Search_BFS and countCommonNeighbors over to word-at-a-time AND/popcount kernels.
+         * Only allowed for unweighted Graphs (every weight 1.0) small enough to be dense.
+         * 
+         * @param max_nodes Largest Graph to build it for. The default caps the matrix at 32 MB.
+         * @return true if the bit matrix is now in use, false if the Graph is weighted or too large
+         */
+        bool useBitMatrix(size_t max_nodes = 16384);
+
+        /**
+         * @brief Frees the bit-packed adjacency matrix, going back to CSR-only kernels
+         */
+        void dropBitMatrix();
+
+        /**
+         * @brief Checks if the bit-packed adjacency matrix is in use
+         */
+        inline bool hasBitMatrix() const { return bits_.size() != 0; }
+
+        /**
+         * @brief Get a const reference to the bit-packed adjacency matrix. Empty unless useBitMatrix() succeeded.
+         */
+        inline const BitMatrix& getBitMatrix() const { return bits_; }
+
+        /**
+         * @brief Counts the Vertices that both a and b have an Edge to (mutual friends)
+         * 
+         * @param a First vertex
+         * @param b Second vertex
+         * @return size_t Number of common out-neighbors
+         */
+        size_t countCommonNeighbors(Vertex a, Vertex b) const;
+
+        /**
+         * @brief Counts the triangles: triples a < b < c with Edges a->b, a->c and b->c. On a double
+         * directed Graph that is the number of triangles (groups of 3 mutual friends).
+         * 
+         * @return size_t Number of triangles
+         */
+        size_t countTriangles() const;
+
+        /**
+         * @brief Relabels every Vertex v as new_id[v], rebuilding the CSR arrays (and the incoming index and
+         * bit matrix, if in use) in the new order. Pair it with a permutation from Reorder to lay out
+         * neighboring Vertices close together in memory, and with IdMap::permute() to map results back
+         * to the original ids. Also works on a Graph loaded from a snapshot, which can then be saved again.
+         * 
+         * @param new_id Permutation of 0..getSize()-1
+         * @return true if relabeled, false (leaving the Graph unchanged) if new_id is not a permutation
+         */
+        bool reorder(const vector<Vertex>& new_id);
+
         /**
          * @brief Get the Size of the Graph. Equivalent to getMaxVertex().
          * 
          * @return size_t Size of graph
          */
-        inline size_t getSize() const { return matrix_.size(); }
+        inline size_t getSize() const { return offsets_.size() - 1; }
+
+        /**
+         * @brief Get the number of (directed) Edges stored in the Graph. A double directed
+         * Edge counts twice, once for each direction.
+         * 
+         * @return size_t Number of stored Edges
+         */
+        inline size_t getEdgeCount() const { return neighbors_.size(); }
+
+        /**
+         * @brief Get the number of bytes taken by the CSR arrays (outgoing and incoming), not counting the bit matrix
+         */
+        inline size_t memoryBytes() const {
+            return sizeof(size_t) * (offsets_.size() + in_offsets_.size()) + sizeof(Vertex) * (neighbors_.size() + in_neighbors_.size()) +
+                   sizeof(Stored) * (weights_.size() + in_weights_.size());
+        }
 
         /**
          * @brief Get the Max Vertex object Equivalent to getSize() - 1.
@@ -204,23 +509,23 @@ class Graph {
         inline Vertex getMaxVertex() const { return getSize() - 1; }
 
         /**
-         * @brief Insertion operator to print the Adjacency Matrix.
+         * @brief Insertion operator to print the (dense) Adjacency Matrix.
          * 
          * @param out ostream ref for operator chaining
          * @param g Graph to output
          * @return std::ostream& ostream ref for operator chaining
          */
-        friend std::ostream& operator<<(std::ostream& out, const Graph& g);
+        friend std::ostream& operator<<(std::ostream& out, const BasicGraph& g) { g.print(out); return out; }
 
         /**
-         * @brief Equality checking operator. Compares the adjacency matrices, entry by entry.
+         * @brief Equality checking operator. Compares the adjacency lists and weights, entry by entry.
          * 
          * @param lhs First Graph
          * @param rhs Second Graph
          * @return true if adjacency matrices are the same
          * @return false if not
          */
-        friend bool operator==(const Graph& lhs, const Graph& rhs);
+        friend bool operator==(const BasicGraph& lhs, const BasicGraph& rhs) { return lhs.equals(rhs); }
 
         /**
          * @brief Inequality operator. Logical inverse of operator==
@@ -230,14 +535,15 @@ class Graph {
          * @return true if the adjacency matrices are NOT the same
          * @return false otherwise
          */
-        inline friend bool operator!=(const Graph& lhs, const Graph& rhs) { return !(lhs == rhs); }
+        inline friend bool operator!=(const BasicGraph& lhs, const BasicGraph& rhs) { return !(lhs == rhs); }
  
         /**
-         * @brief Get a const reference of the Adjacency Matrix. Const ref to avoid extra copy
+         * @brief Builds the dense Adjacency Matrix from the CSR storage. Costs O(n^2) memory,
+         * so only use it on small graphs.
          * 
-         * @return const vector<vector<double>>& Constant reference to the matrix
+         * @return vector<vector<double>> The matrix, with 0 for missing Edges
          */
-        inline const vector<vector<double>>& getAdjacencyMatrix() const { return matrix_; }
+        vector<vector<double>> getAdjacencyMatrix() const;
 
 
         /**
@@ -250,6 +556,37 @@ class Graph {
          */
         vector<int> iddfs(int start, int end, int max_depth);
 
+        /**
+         * @brief IDDFS that does not re-explore cycles: Vertices already on the current path are skipped (a
+         * bitset, n / 8 bytes), and an optional transposition table remembers, for the current depth limit, the
+         * most remaining depth each Vertex was fully explored with, so reaching it again with no more depth
+         * to spare is skipped too. The table is a fixed array of table_bytes, indexed by Vertex, where a newer
+         * entry replaces an older one; 0 turns it off. An iteration that never hits the depth limit ends the
+         * search early, since deeper ones cannot reach anything new.
+         * 
+         * @param start Starting Vertex
+         * @param end End Vertex
+         * @param max_depth Same as for iddfs(): depth limits 1 to max_depth - 1 are tried
+         * @param table_bytes Memory budget for the transposition table
+         * @return vector<Vertex> A shortest path from start to end, both included, or empty if there is none within the limits
+         */
+        vector<Vertex> boundedIddfs(Vertex start, Vertex end, int max_depth, size_t table_bytes = 0) const;
+
+        /**
+         * @brief IDDFS with each depth limit split across the workers of pool. The search tree is cut a few
+         * levels below start into prefix paths, in DFS order, which workers take one at a time from a shared
+         * counter and search to the depth limit, skipping Vertices already on the path. A worker that finds end
+         * cancels every prefix after its own, while the ones before it keep going, so the path returned is the
+         * one the sequential search finds first.
+         * 
+         * @param start Starting Vertex
+         * @param end End Vertex
+         * @param max_depth Maximum depth to search to, as for iddfs()
+         * @param pool Workers to use
+         * @return vector<int> The same path iddfs(start, end, max_depth) returns
+         */
+        vector<int> parallelIddfs(int start, int end, int max_depth, ThreadPool& pool) const;
+
         /**
          * @brief Helper function for the IDDFS, recursively does a depth-limited search
          * 
@@ -268,7 +605,157 @@ class Graph {
          * @param g graph to be traversed.
          * @return vector of ints that represents shortest path
          */
-        vector<int> BFS(int start, const Graph& g);
+        vector<int> BFS(int start, const BasicGraph& g);
+
+        /**
+         * @brief BFS as above, with its visited marks, parents, distances and queue in ws, which is reset
+         * first. Nothing is allocated but the result, so many small traversals stay cheap.
+         * 
+         * @param start starting graph vertex
+         * @param ws Workspace to use. Afterwards it holds the parent and distance of every Vertex reached.
+         * @return vector<int> Vertices in the order they were visited
+         */
+        vector<int> BFS(Vertex start, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief Lazy BFS: the Vertices BFS would return, each with its level, computed only as they are
+         * iterated, so stopping early skips the rest of the traversal
+         * 
+         * @param start starting graph vertex
+         * @param ws Workspace for the queue and visited marks. Reset here, and in use until the iteration is over.
+         * @return BreadthFirstRange<BasicGraph> Range of TraversalStep, e.g. for a range-based for
+         */
+        inline BreadthFirstRange<BasicGraph> bfsRange(Vertex start, TraversalWorkspace& ws) const {
+            return BreadthFirstRange<BasicGraph>(*this, start, ws);
+        }
+
+        /**
+         * @brief Direction-optimizing BFS (Beamer et al.): expands small frontiers top-down, pushing along
+         * outgoing Edges, and switches to bottom-up for the few huge middle frontiers of a small-world Graph,
+         * where every unvisited Vertex looks for any parent in the frontier through its incoming Edges and
+         * stops at the first one. The frontier and visited set are bitmaps while going bottom-up.
+         * 
+         * @param start starting graph vertex
+         * @param alpha Go bottom-up once the Edges out of the frontier exceed 1/alpha of the Edges into unvisited Vertices
+         * @param beta Go back top-down once the frontier is shrinking and holds fewer than 1/beta of the Vertices
+         * @return vector<int> BFS level (number of Edges from start) of every Vertex, -1 where unreachable
+         */
+        vector<int> directionOptimizingBFS(Vertex start, double alpha = 15, double beta = 18) const;
+
+        /**
+         * @brief Level-synchronous parallel BFS: each frontier is split across the workers of pool, which claim
+         * unvisited Vertices atomically and collect them in per-worker buffers that become the next frontier.
+         * 
+         * @param start starting graph vertex
+         * @param pool Workers to use
+         * @param depth Set to the BFS level of every Vertex, -1 where unreachable
+         * @param deterministic If true, every Vertex is claimed by its earliest parent in BFS order (an atomic
+         * min), which makes the traversal identical to BFS(start, *this). If false, whichever parent gets there
+         * first wins: the levels are the same, the order within a level is not.
+         * @return vector<int> Vertices in the order they were visited, level by level
+         */
+        vector<int> parallelBFS(Vertex start, ThreadPool& pool, vector<int>& depth, bool deterministic = false) const;
+
+        /**
+         * @brief Multi-source BFS (Then et al., VLDB 2015): runs the BFS from 64 sources at a time. Every Vertex
+         * keeps one bit per source, so a level is a single pass over the frontier that ORs each Vertex's bits into
+         * its neighbors, and the Graph is read once per 64 sources instead of once per source.
+         * 
+         * @param sources Vertices to start from, any number of them
+         * @return vector<vector<int>> BFS level of every Vertex from sources[i], -1 where unreachable
+         */
+        vector<vector<int>> multiSourceBFS(const vector<Vertex>& sources) const;
+
+        /**
+         * @brief Closeness centrality along outgoing Edges, from the multi-source BFS: the number of other
+         * Vertices reached divided by the sum of their distances. 0 when nothing else is reachable.
+         * 
+         * @param sources Vertices to compute it for
+         * @return vector<double> Closeness of every Vertex in sources
+         */
+        vector<double> closeness(const vector<Vertex>& sources) const;
+
+        /**
+         * @brief Eccentricity along outgoing Edges, from the multi-source BFS: the distance to the farthest
+         * reachable Vertex
+         * 
+         * @param sources Vertices to compute it for
+         * @return vector<int> Eccentricity of every Vertex in sources, -1 if it is not in the Graph
+         */
+        vector<int> eccentricity(const vector<Vertex>& sources) const;
+
+        /**
+         * @brief Everything within k hops of source ("friends of friends" for k = 2), grouped by hop. A BFS that
+         * stops expanding at depth k, so it only costs what it finds.
+         * 
+         * @param source Vertex to start from
+         * @param k Number of hops, along outgoing Edges
+         * @param ws Workspace to use, reset first
+         * @return vector<vector<Vertex>> k + 1 groups: the Vertices exactly d hops away are in group d, in BFS
+         * order (group 0 is source itself). All empty if source is not in the Graph.
+         */
+        vector<vector<Vertex>> kHopNeighborhood(Vertex source, int k, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief kHopNeighborhood for every Vertex in sources, one after the other in the same workspace
+         */
+        vector<vector<vector<Vertex>>> kHopNeighborhood(const vector<Vertex>& sources, int k, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief Only the size of every group kHopNeighborhood would return, without building the groups
+         * 
+         * @param source Vertex to start from
+         * @param k Number of hops, along outgoing Edges
+         * @param ws Workspace to use, reset first
+         * @return vector<size_t> k + 1 counts: how many Vertices are exactly d hops away
+         */
+        vector<size_t> kHopCounts(Vertex source, int k, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief kHopCounts for every Vertex in sources, one after the other in the same workspace
+         */
+        vector<vector<size_t>> kHopCounts(const vector<Vertex>& sources, int k, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief Every shortest path (in Edges) from source at once: a BFS that keeps the parent and distance of
+         * each Vertex it reaches, so a path to any target is then read back in O(path length). Keep the tree,
+         * or a ShortestPathCache, to answer many queries from the same source without searching again.
+         * 
+         * @param source Vertex the paths start from
+         * @param ws Workspace to use, reset first
+         * @return ShortestPathTree Parent and distance of every Vertex reachable from source. Reaches nothing if
+         * source is not in the Graph.
+         */
+        ShortestPathTree shortestPathTree(Vertex source, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief shortestPathTree as above, in a workspace of its own
+         */
+        ShortestPathTree shortestPathTree(Vertex source) const;
+
+        /**
+         * @brief Dijkstra's single-source shortest paths along outgoing Edges, summing their weights, with a
+         * 4-ary heap (see DaryHeap). O((V + E) log V). Weights must be non-negative: negative Edges are skipped.
+         * 
+         * @param source Vertex the paths start from
+         * @return ShortestPathTree Parent and weighted distance of every Vertex reachable from source. Reaches
+         * nothing if source is not in the Graph.
+         */
+        ShortestPathTree dijkstra(Vertex source) const;
+
+        /**
+         * @brief Parallel delta-stepping (Meyer & Sanders): Vertices are bucketed by distance in steps of delta,
+         * and the whole lowest bucket is relaxed at once by the workers of pool. Edges of at most delta are
+         * relaxed until the bucket stops changing, heavier ones once it has settled. Small deltas approach
+         * Dijkstra (little wasted work, little parallelism), large ones Bellman-Ford.
+         * 
+         * @param source Vertex the paths start from
+         * @param pool Workers to use
+         * @param delta Bucket width, or 0 to use the mean Edge weight (which makes it a BFS on an unweighted Graph)
+         * @return ShortestPathTree Same distances as dijkstra(), up to rounding of non-integer weights. The parent of each Vertex is the one whose relaxation
+         * set its distance, so where there are several shortest paths, which one is kept depends on thread timing.
+         */
+        ShortestPathTree deltaStepping(Vertex source, ThreadPool& pool, double delta = 0) const;
 
         /**
          * @brief DFS traversal to find shortest path from a vertex - used to compare with Iterative Depth DFS implementation.
@@ -278,7 +765,92 @@ class Graph {
          * @param visited vector array of bools marking if already visited
          * @param dfsTraversal since its iterative return needs to be a pointer to a vector.
          */
-        void DFS(int start, const Graph& g, vector<bool> &visited, vector<int> &dfsTraversal);
+        void DFS(int start, const BasicGraph& g, vector<bool> &visited, vector<int> &dfsTraversal);
+
+        /**
+         * @brief DFS as above, with its visited marks in ws, which is reset first
+         * 
+         * @param start starting graph vertex
+         * @param ws Workspace to use. Afterwards it holds the DFS tree parent and depth of every Vertex reached.
+         * @return vector<int> Vertices in the order they were visited
+         */
+        vector<int> DFS(Vertex start, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief Lazy DFS: the Vertices DFS would return, each with its depth in the DFS tree, computed only
+         * as they are iterated, so stopping early skips the rest of the traversal
+         * 
+         * @param start starting graph vertex
+         * @param ws Workspace for the visited marks. Reset here, and in use until the iteration is over.
+         * @return DepthFirstRange<BasicGraph> Range of TraversalStep, e.g. for a range-based for
+         */
+        inline DepthFirstRange<BasicGraph> dfsRange(Vertex start, TraversalWorkspace& ws) const {
+            return DepthFirstRange<BasicGraph>(*this, start, ws);
+        }
+
+        /**
+         * @brief The DFS engine behind DFS and Search_DFS. Iterative, with an explicit stack of (Vertex, next
+         * neighbor) frames, so it goes as deep as the Graph does without growing the call stack. Visits in the
+         * same order as the recursive version would.
+         * 
+         * @param start starting graph vertex, visited even if already marked
+         * @param visited Marks the Vertices visited so far, one per Vertex; updated as it goes
+         * @param pre Called as pre(v) when v is first reached. Returning true stops the search right there.
+         * @param post Called as post(v) once every Vertex reachable through v is done. Not called for the
+         * Vertices still on the stack when pre stops the search.
+         * @return bool True if pre stopped the search
+         */
+        template <typename Pre, typename Post>
+        bool depthFirst(Vertex start, vector<bool>& visited, Pre pre, Post post) const {
+            visited[start] = true;
+            PrePostVisitor<Pre, Post> visitor(pre, post);
+            return depthFirstFrom(start, [&visited](Vertex u, Vertex, int) {
+                if (visited[u]) return false;
+                visited[u] = true;
+                return true;
+            }, visitor);
+        }
+
+        /**
+         * @brief depthFirst with its visited marks in ws, which also records the DFS tree parent and depth of
+         * every Vertex. ws is not reset, so several calls can share one traversal, as with the vector<bool>.
+         */
+        template <typename Pre, typename Post>
+        bool depthFirst(Vertex start, TraversalWorkspace& ws, Pre pre, Post post) const {
+            PrePostVisitor<Pre, Post> visitor(pre, post);
+            return depthFirst(start, ws, visitor);
+        }
+
+        /**
+         * @brief The generic DFS every other one is an instance of: same order as depthFirst, with each step
+         * reported to visitor (see TraversalVisitor). ws is not reset, so several calls can share one traversal.
+         * 
+         * @param start starting graph vertex, visited even if already marked
+         * @param ws Workspace holding the visited marks. Also gets the DFS tree parent and depth of every Vertex.
+         * @param visitor Hooks to call
+         * @return bool True if visitor.shouldStop ended the traversal
+         */
+        template <typename Visitor>
+        bool depthFirst(Vertex start, TraversalWorkspace& ws, Visitor& visitor) const {
+            ws.visit(start);
+            return depthFirstFrom(start, [&ws](Vertex u, Vertex parent, int depth) { return ws.visit(u, parent, depth); }, visitor);
+        }
+
+        /**
+         * @brief The generic BFS every other one is an instance of: visits level by level, with each step
+         * reported to visitor (see TraversalVisitor). ws is not reset, so several calls can share one traversal.
+         * 
+         * @param start starting graph vertex, visited even if already marked
+         * @param ws Workspace holding the visited marks and queue. Also gets the parent and distance of every Vertex.
+         * @param visitor Hooks to call
+         * @param max_depth Vertices this many Edges from start are discovered but not expanded, -1 for no limit
+         * @return bool True if visitor.shouldStop ended the traversal
+         */
+        template <typename Visitor>
+        bool breadthFirst(Vertex start, TraversalWorkspace& ws, Visitor& visitor, int max_depth = -1) const {
+            ws.visit(start);
+            return breadthFirstFrom(start, ws.queue(), [&ws](Vertex u, Vertex parent, int depth) { return ws.visit(u, parent, depth); }, visitor, max_depth);
+        }
 
         /**
          * @brief BFS traversal to find shortest path from a vertex to target.
@@ -288,7 +860,42 @@ class Graph {
          * @param g graph to be traversed.
          * @return vector of ints that represents shortest path
          */
-        vector<int> Search_BFS(int start, int end, const Graph& g);
+        vector<int> Search_BFS(int start, int end, const BasicGraph& g);
+
+        /**
+         * @brief Search_BFS as above, with its visited marks, parents, distances and queue in ws, which is reset first
+         * 
+         * @param start starting graph vertex
+         * @param end ending graph vertex
+         * @param ws Workspace to use
+         * @return vector<int> Vertices in the order they were visited, up to end
+         */
+        vector<int> Search_BFS(Vertex start, Vertex end, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief Bidirectional BFS: searches forward from start along outgoing Edges and backward from end along
+         * incoming Edges, one level at a time, always expanding the smaller frontier, until the two meet. Both
+         * searches only go about half the distance, which on a small-world Graph explores a tiny fraction of
+         * what a one-sided search to the same depth does.
+         * 
+         * @param start Starting Vertex
+         * @param end Ending Vertex
+         * @return vector<Vertex> A shortest path from start to end, both included (its length in Edges is
+         * size() - 1). Empty if end is unreachable.
+         */
+        vector<Vertex> bidirectionalBFS(Vertex start, Vertex end) const;
+
+        /**
+         * @brief bidirectionalBFS with each side's marks, parents, distances and queue in a workspace, both reset
+         * first, so a query costs only what it explores
+         * 
+         * @param start Starting Vertex
+         * @param end Ending Vertex
+         * @param forward Workspace for the search from start
+         * @param backward Workspace for the search from end
+         * @return vector<Vertex> A shortest path from start to end, both included. Empty if end is unreachable.
+         */
+        vector<Vertex> bidirectionalBFS(Vertex start, Vertex end, TraversalWorkspace& forward, TraversalWorkspace& backward) const;
 
         /**
          * @brief DFS traversal to find shortest path from a vertex 
@@ -301,7 +908,17 @@ class Graph {
          * @param dfsTraversal since its iterative return needs to be a pointer to a vector.
          * @return vector of ints that represents shortest path
          */
-        void Search_DFS(int start, int end, const Graph& g, vector<bool> &visited, vector<int> &dfsTraversal);
+        void Search_DFS(int start, int end, const BasicGraph& g, vector<bool> &visited, vector<int> &dfsTraversal);
+
+        /**
+         * @brief Search_DFS as above, with its visited marks in ws, which is reset first
+         * 
+         * @param start starting graph vertex
+         * @param end ending graph vertex
+         * @param ws Workspace to use
+         * @return vector<int> Vertices in the order they were visited, up to end
+         */
+        vector<int> Search_DFS(Vertex start, Vertex end, TraversalWorkspace& ws) const;
 
          /**
           * @brief Floyd Warshall shortest path algorithm.
@@ -341,14 +958,47 @@ class Graph {
 
     private:
         /**
-         * @brief Adjacency matrix
+         * @brief CSR row offsets, size num_nodes + 1. The outgoing Edges of Vertex v are stored
+         * at indices offsets_[v] to offsets_[v + 1] - 1 of neighbors_ (and weights_).
+         */
+        Buffer<size_t> offsets_;
+
+        /**
+         * @brief CSR column indices: the ending Vertex of every Edge, sorted ascending within each row
+         */
+        Buffer<Vertex> neighbors_;
+
+        /**
+         * @brief Weights parallel to neighbors_. Left empty while every weight is 1.0,
+         * which is the case for everything read in through the FileReader, and always for bool Weights.
+         */
+        Buffer<Stored> weights_;
+
+        /**
+         * @brief Reverse (incoming) CSR index, laid out like offsets_/neighbors_/weights_: the starting
+         * Vertices of every Edge arriving at v are in_neighbors_[in_offsets_[v]] to in_neighbors_[in_offsets_[v + 1] - 1],
+         * sorted ascending.
+         */
+        Buffer<size_t> in_offsets_;
+        Buffer<Vertex> in_neighbors_;
+        Buffer<Stored> in_weights_;
+
+        /**
+         * @brief True while every Edge has its reverse with the same weight (double directed, and no
+         * directional changeWeight since). The incoming index is then identical to the outgoing one,
+         * so it is left empty and incoming queries read offsets_/neighbors_ instead.
          */
-        vector<vector<double>> matrix_;
+        bool in_shared_;
+
+        /**
+         * @brief Optional bit-packed adjacency matrix, see useBitMatrix(). Empty when not in use.
+         */
+        BitMatrix bits_;
 
         /**
          * @brief Vector of vertices in graph
          */
-        vector<Vertex> vertices;
+        Buffer<Vertex> vertices;
 
         /**
          * @brief Bool to identify directedness of graph
@@ -366,6 +1016,174 @@ class Graph {
          */
         void __init(const vector<Edge>& edges, size_t num_nodes, bool double_directed);
 
+        /**
+         * @brief Helper function for the id constructor. Same as above, for a flat id list.
+         */
+        void __init(const vector<uint64_t>& ids, size_t num_nodes, bool double_directed);
+
+        /**
+         * @brief Helper function: Does the actual CSR build for both __init overloads
+         * 
+         * @param num_edges Number of Edges given
+         * @param edge_at Callable returning the i-th Edge
+         * @param num_nodes Total number of nodes
+         * @param double_directed Boolean flag, see __init
+         */
+        template <typename EdgeAt>
+        void __build(size_t num_edges, EdgeAt edge_at, size_t num_nodes, bool double_directed);
+
+        /**
+         * @brief Helper function: Finds where the Edge from start to end is stored
+         * 
+         * @param start Starting vertex
+         * @param end Ending vertex
+         * @return size_t Index of the Edge in neighbors_, or neighbors_.size() if it does not exist
+         */
+        size_t findEdge(Vertex start, Vertex end) const;
+
+        /**
+         * @brief Helper function: BFS / Search_BFS over the bit matrix, where the unvisited neighbors of a
+         * Vertex are found 64 at a time (row AND NOT visited) instead of Edge by Edge
+         * 
+         * @param start starting graph vertex
+         * @param end Vertex to stop at, -1 to visit everything reachable
+         * @return vector<int> Vertices in the order they were visited
+         */
+        vector<int> bitMatrixSearch(int start, int end) const;
+
+        /**
+         * @brief Helper function: The BFS behind kHopNeighborhood and kHopCounts. Leaves every Vertex within
+         * k hops of source in ws.queue(), in BFS order, with its distance in ws.
+         */
+        void kHopSearch(Vertex source, int k, TraversalWorkspace& ws) const;
+
+        /**
+         * @brief Helper function: Adapts the pre(v) / post(v) callbacks of depthFirst to a TraversalVisitor
+         */
+        template <typename Pre, typename Post>
+        struct PrePostVisitor : TraversalVisitor {
+            Pre& pre;
+            Post& post;
+            bool stop;
+            PrePostVisitor(Pre& pre_fn, Post& post_fn) : pre(pre_fn), post(post_fn), stop(false) {}
+            inline void onDiscover(Vertex v, Vertex, int) { stop = pre(v); }
+            inline bool shouldStop(Vertex) { return stop; }
+            inline void onFinish(Vertex v) { post(v); }
+        };
+
+        /**
+         * @brief Helper function: The one BFS loop, from an already marked start, with queue as the queue (it
+         * ends up holding every Vertex discovered, in order). mark(u, parent, depth) marks u as visited and
+         * returns true, or returns false if it already was. Stops before expanding the level at max_depth.
+         */
+        template <typename Queue, typename Mark, typename Visitor>
+        bool breadthFirstFrom(Vertex start, Queue& queue, Mark mark, Visitor& visitor, int max_depth = -1) const {
+            queue.clear();
+            queue.push_back(start);
+            visitor.onDiscover(start, TraversalWorkspace::NONE, 0);
+            if (visitor.shouldStop(start))
+                return true;
+            int depth = 0;
+            for (size_t head = 0, level_end = 1; head < queue.size() && depth != max_depth; ++head) {
+                if (head == level_end) {
+                    depth++;
+                    level_end = queue.size();
+                    if (depth == max_depth) break;
+                }
+                Vertex v = queue[head];
+                for (Vertex u : neighbors(v)) {
+                    if (!visitor.onEdge(v, u) || !mark(u, v, depth + 1)) continue;
+                    queue.push_back(u);
+                    visitor.onDiscover(u, v, depth + 1);
+                    if (visitor.shouldStop(u))
+                        return true;
+                }
+                visitor.onFinish(v);
+            }
+            return false;
+        }
+
+        /**
+         * @brief Helper function: The one DFS loop, iterative, with an explicit stack of (Vertex, next neighbor)
+         * frames, from an already marked start. mark is as for breadthFirstFrom.
+         */
+        template <typename Mark, typename Visitor>
+        bool depthFirstFrom(Vertex start, Mark mark, Visitor& visitor) const {
+            visitor.onDiscover(start, TraversalWorkspace::NONE, 0);
+            if (visitor.shouldStop(start))
+                return true;
+            vector<std::pair<Vertex, size_t>> stack(1, std::make_pair(start, size_t(0)));
+            while (!stack.empty()) {
+                Vertex v = stack.back().first;
+                int depth = int(stack.size());
+                Neighbors adj = neighbors(v);
+                size_t next = stack.back().second;
+                while (next < adj.size() && !(visitor.onEdge(v, adj[next]) && mark(adj[next], v, depth))) ++next;
+                if (next == adj.size()) {
+                    stack.pop_back();
+                    visitor.onFinish(v);
+                    continue;
+                }
+                // resume v after this neighbor, which goes on top
+                stack.back().second = next + 1;
+                Vertex u = adj[next];
+                visitor.onDiscover(u, v, depth);
+                if (visitor.shouldStop(u))
+                    return true;
+                stack.emplace_back(u, 0);
+            }
+            return false;
+        }
+
+        /**
+         * @brief Helper function: The multi-source BFS behind multiSourceBFS, closeness and eccentricity.
+         * Calls visit(i, v, level) once for every Vertex v reachable from sources[i], level by level.
+         */
+        template <typename Visit>
+        void msbfs(const vector<Vertex>& sources, Visit visit) const;
+
+        /**
+         * @brief Helper function: Builds the incoming index by transposing the outgoing one. O(V + E).
+         */
+        void buildIncomingIndex();
+
+        /**
+         * @brief Helper function: Sets the weight of entry (row, col) of a CSR index, inserting it if
+         * missing and erasing it if weight is 0. Shared by the outgoing and incoming indices.
+         * 
+         * @param offsets Row offsets of the index
+         * @param cols Column indices of the index
+         * @param weights Weights of the index, empty while all are 1.0
+         * @param row Row to change
+         * @param col Column to change
+         * @param weight New weight
+         */
+        static void setEntry(vector<size_t>& offsets, vector<Vertex>& cols, vector<Stored>& weights,
+                             Vertex row, Vertex col, double weight);
+
+        /**
+         * @brief Helper function: Weight of the Edge stored at index idx of neighbors_
+         */
+        inline double weightAt(size_t idx) const {
+            return !WeightTraits<Weight>::weighted || weights_.empty() ? 1.0 : double(weights_[idx]);
+        }
+
+        /**
+         * @brief Helper function: True while the incoming index is the outgoing one (see in_shared_).
+         * A compile time constant unless Direction is RuntimeDirected.
+         */
+        inline bool inShared() const { return Direction::runtime ? in_shared_ : Direction::symmetric; }
+
+        /**
+         * @brief Helper function: Prints the (dense) Adjacency Matrix, for operator<<
+         */
+        void print(std::ostream& out) const;
+
+        /**
+         * @brief Helper function: Compares the adjacency lists and weights, for operator==
+         */
+        bool equals(const BasicGraph& other) const;
+
         /**
          * @brief Helper function: Finds smallest and largest lengths of paths in graph
          * 
@@ -375,3 +1193,19 @@ class Graph {
          */
         vector<double> find_min_max_paths(const vector<vector<double>> fw_matrix);
 };
+
+/**
+ * @brief Runs X(Weight, Direction) for every BasicGraph compiled into Graph.cpp
+ */
+#define FOR_EACH_BASIC_GRAPH(X) \
+    X(bool, Directed) X(bool, Undirected) X(bool, RuntimeDirected) \
+    X(uint8_t, Directed) X(uint8_t, Undirected) X(uint8_t, RuntimeDirected) \
+    X(float, Directed) X(float, Undirected) X(float, RuntimeDirected) \
+    X(double, Directed) X(double, Undirected) X(double, RuntimeDirected)
+
+// Every member is defined (and instantiated) in Graph.cpp
+#define DECLARE_BASIC_GRAPH(W, D) extern template class BasicGraph<W, D>;
+FOR_EACH_BASIC_GRAPH(DECLARE_BASIC_GRAPH)
+#undef DECLARE_BASIC_GRAPH
+
+typedef BasicGraph<double, RuntimeDirected> Graph;
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "IdMap.h"
+
+IdMap IdMap::identity(size_t n) {
+    IdMap map;
+    map.keys_.resize(n);
+    for (size_t i = 0; i < n; ++i) map.keys_[i] = i;
+    return map;
+}
+
+void IdMap::compact(vector<uint64_t>& ids) {
+    numeric_ = true;
+    names_.clear();
+    to_internal_.clear();
+    to_position_.clear();
+
+    keys_ = ids;
+    std::sort(keys_.begin(), keys_.end());
+    keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+    keys_.shrink_to_fit();
+
+    // Already dense (0..n-1): every id is its own internal id
+    if (keys_.empty() || keys_.back() == keys_.size() - 1)
+        return;
+
+    for (uint64_t& id : ids) id = std::lower_bound(keys_.begin(), keys_.end(), id) - keys_.begin();
+}
+
+vector<uint64_t> IdMap::compact(const vector<string>& tokens) {
+    numeric_ = false;
+    keys_.clear();
+    to_internal_.clear();
+    to_position_.clear();
+
+    names_ = tokens;
+    std::sort(names_.begin(), names_.end());
+    names_.erase(std::unique(names_.begin(), names_.end()), names_.end());
+    names_.shrink_to_fit();
+
+    vector<uint64_t> ids(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i)
+        ids[i] = std::lower_bound(names_.begin(), names_.end(), tokens[i]) - names_.begin();
+    return ids;
+}
+
+bool IdMap::toInternal(uint64_t external, Vertex& internal) const {
+    if (!numeric_)
+        return false;
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), external);
+    if (it == keys_.end() || *it != external)
+        return false;
+    internal = internalAt(it - keys_.begin());
+    return true;
+}
+
+bool IdMap::toInternal(const string& external, Vertex& internal) const {
+    if (numeric_) {
+        // a numeric map still answers for ids given as text, but only plain digits: no sign or spaces
+        // (strtoull would turn "-1" into 2^64 - 1), and nothing past 2^64 - 1
+        uint64_t id = 0;
+        for (char c : external) {
+            uint64_t digit = uint64_t(c - '0');
+            if (digit > 9 || id > (UINT64_MAX - digit) / 10)
+                return false;
+            id = id * 10 + digit;
+        }
+        return !external.empty() && toInternal(id, internal);
+    }
+    auto it = std::lower_bound(names_.begin(), names_.end(), external);
+    if (it == names_.end() || *it != external)
+        return false;
+    internal = internalAt(it - names_.begin());
+    return true;
+}
+
+uint64_t IdMap::toExternal(Vertex internal) const {
+    return numeric_ ? keys_[positionOf(internal)] : 0;
+}
+
+string IdMap::toExternalString(Vertex internal) const {
+    return numeric_ ? std::to_string(keys_[positionOf(internal)]) : names_[positionOf(internal)];
+}
+
+void IdMap::permute(const vector<Vertex>& new_id) {
+    vector<Vertex> to_internal(size());
+    vector<size_t> to_position(size());
+    for (size_t pos = 0; pos < size(); ++pos) {
+        Vertex v = new_id[internalAt(pos)];
+        to_internal[pos] = v;
+        to_position[v] = pos;
+    }
+    to_internal_.swap(to_internal);
+    to_position_.swap(to_position);
+}
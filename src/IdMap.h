@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+typedef size_t Vertex;
+
+/**
+ * Bidirectional map between arbitrary external vertex ids (64-bit integers or strings, e.g.
+ * user names or hashes) and the dense internal ids 0..n-1 a Graph is built on. Compacting
+ * means a sparse input such as {10^9, 7, 2^63} makes a 3 Vertex Graph instead of one sized
+ * by its largest id.
+ *
+ * Internal ids follow the sorted order of the external ones, so input that is already
+ * 0..n-1 maps to itself. Both directions are array lookups (external to internal is a
+ * binary search), with no hash tables.
+ */
+class IdMap {
+    public:
+        /**
+         * @brief Construct an empty map
+         */
+        IdMap() : numeric_(true) {}
+
+        /**
+         * @brief Construct the identity map over 0..n-1
+         */
+        static IdMap identity(size_t n);
+
+        /**
+         * @brief Builds the map from every id in ids, then replaces each one with its internal id in
+         * place. A flat Edge list from FileReader::fileToIds can go to Graph(ids, ...) right after.
+         *
+         * @param ids External ids, rewritten to internal ids
+         */
+        void compact(vector<uint64_t>& ids);
+
+        /**
+         * @brief Builds the map from string ids, e.g. tokens from FileReader::fileToVector
+         *
+         * @param tokens External ids
+         * @return vector<uint64_t> Internal id of every token, in the same order
+         */
+        vector<uint64_t> compact(const vector<string>& tokens);
+
+        /**
+         * @brief Number of distinct ids, i.e. the number of Vertices
+         */
+        inline size_t size() const { return numeric_ ? keys_.size() : names_.size(); }
+
+        /**
+         * @brief True if the map was built from numeric ids, false if from strings
+         */
+        inline bool isNumeric() const { return numeric_; }
+
+        /**
+         * @brief Looks up the internal id of a numeric external id
+         *
+         * @param external External id
+         * @param internal Set to the internal id if found
+         * @return true if the id is in the map
+         */
+        bool toInternal(uint64_t external, Vertex& internal) const;
+
+        /**
+         * @brief Looks up the internal id of a string external id
+         *
+         * @param external External id. For a numeric map, only plain decimal digits (no sign or spaces) up to 2^64 - 1.
+         * @param internal Set to the internal id if found
+         * @return true if the id is in the map
+         */
+        bool toInternal(const string& external, Vertex& internal) const;
+
+        /**
+         * @brief Numeric external id of a Vertex. Only meaningful if isNumeric().
+         */
+        uint64_t toExternal(Vertex internal) const;
+
+        /**
+         * @brief External id of a Vertex as text, whether it was numeric or a string
+         */
+        string toExternalString(Vertex internal) const;
+
+        /**
+         * @brief Relabels the internal ids, e.g. after reordering the Graph: Vertex v becomes new_id[v].
+         *
+         * @param new_id Permutation of 0..size()-1
+         */
+        void permute(const vector<Vertex>& new_id);
+
+    private:
+        /**
+         * @brief True for numeric keys (keys_), false for string keys (names_)
+         */
+        bool numeric_;
+
+        /**
+         * @brief Sorted, distinct numeric external ids
+         */
+        vector<uint64_t> keys_;
+
+        /**
+         * @brief Sorted, distinct string external ids
+         */
+        vector<string> names_;
+
+        /**
+         * @brief Internal id of the key at each sorted position. Empty while internal id == position.
+         */
+        vector<Vertex> to_internal_;
+
+        /**
+         * @brief Sorted position of each internal id's key. Empty while internal id == position.
+         */
+        vector<size_t> to_position_;
+
+        /**
+         * @brief Helper function: Internal id of the key at a sorted position
+         */
+        inline Vertex internalAt(size_t pos) const { return to_internal_.empty() ? pos : to_internal_[pos]; }
+
+        /**
+         * @brief Helper function: Sorted position of an internal id's key
+         */
+        inline size_t positionOf(Vertex internal) const { return to_position_.empty() ? internal : to_position_[internal]; }
+};
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Reorder.h"
+
+template <typename GraphT>
+void Reorder::undirected(const GraphT& g, vector<size_t>& offsets, vector<Vertex>& adj) {
+    size_t n = g.getSize();
+    const Buffer<size_t>& in_offsets = g.inShared() ? g.offsets_ : g.in_offsets_;
+    const Buffer<Vertex>& in_neighbors = g.inShared() ? g.neighbors_ : g.in_neighbors_;
+
+    offsets.assign(n + 1, 0);
+    adj.clear();
+    adj.reserve(g.neighbors_.size() * (g.inShared() ? 1 : 2));
+    for (Vertex v = 0; v < n; ++v) {
+        // Both rows are sorted, so their union is a merge
+        size_t i = g.offsets_[v], j = in_offsets[v];
+        while (i < g.offsets_[v + 1] || j < in_offsets[v + 1]) {
+            Vertex u;
+            if (j == in_offsets[v + 1] || (i < g.offsets_[v + 1] && g.neighbors_[i] < in_neighbors[j])) u = g.neighbors_[i++];
+            else if (i == g.offsets_[v + 1] || in_neighbors[j] < g.neighbors_[i]) u = in_neighbors[j++];
+            else u = g.neighbors_[i++], j++;
+            if (u != v) adj.push_back(u);
+        }
+        offsets[v + 1] = adj.size();
+    }
+}
+
+template <typename GraphT>
+vector<Vertex> Reorder::byDegree(const GraphT& g) {
+    size_t n = g.getSize();
+    vector<size_t> offsets;
+    vector<Vertex> adj;
+    undirected(g, offsets, adj);
+
+    vector<Vertex> order(n);
+    for (Vertex v = 0; v < n; ++v) order[v] = v;
+    std::stable_sort(order.begin(), order.end(), [&offsets](Vertex a, Vertex b) {
+        return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b];
+    });
+    return inverse(order);
+}
+
+template <typename GraphT>
+vector<Vertex> Reorder::reverseCuthillMcKee(const GraphT& g) {
+    size_t n = g.getSize();
+    vector<size_t> offsets;
+    vector<Vertex> adj;
+    undirected(g, offsets, adj);
+    auto degree = [&offsets](Vertex v) { return offsets[v + 1] - offsets[v]; };
+    auto by_degree = [&degree](Vertex a, Vertex b) { return degree(a) < degree(b) || (degree(a) == degree(b) && a < b); };
+
+    // Each component starts from its lowest degree Vertex, a cheap stand-in for a peripheral one
+    vector<Vertex> starts(n);
+    for (Vertex v = 0; v < n; ++v) starts[v] = v;
+    std::sort(starts.begin(), starts.end(), by_degree);
+
+    // order doubles as the BFS queue: everything before head has been expanded
+    vector<Vertex> order;
+    order.reserve(n);
+    vector<bool> visited(n, false);
+    for (Vertex s : starts) {
+        if (visited[s]) continue;
+        visited[s] = true;
+        order.push_back(s);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            Vertex v = order[head];
+            size_t first = order.size();
+            for (size_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+                if (!visited[adj[k]]) {
+                    visited[adj[k]] = true;
+                    order.push_back(adj[k]);
+                }
+            }
+            std::sort(order.begin() + first, order.end(), by_degree);
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return inverse(order);
+}
+
+template <typename GraphT>
+vector<Vertex> Reorder::gorder(const GraphT& g, size_t window) {
+    size_t n = g.getSize();
+    if (n == 0)
+        return vector<Vertex>();
+    vector<size_t> offsets;
+    vector<Vertex> adj;
+    undirected(g, offsets, adj);
+    size_t hub = std::max<size_t>(1, size_t(std::sqrt(double(n))));
+    window = std::max<size_t>(1, window);
+
+    // Every unplaced Vertex sits in the doubly linked list of its current score
+    const Vertex NONE = Vertex(-1);
+    vector<size_t> score(n, 0);
+    vector<Vertex> prev(n), next(n), head(1, NONE);
+    vector<bool> placed(n, false);
+    size_t max_score = 0;
+
+    auto unlink = [&](Vertex v) {
+        if (prev[v] != NONE) next[prev[v]] = next[v];
+        else head[score[v]] = next[v];
+        if (next[v] != NONE) prev[next[v]] = prev[v];
+    };
+    auto link = [&](Vertex v) {
+        if (score[v] >= head.size()) head.resize(score[v] + 1, NONE);
+        prev[v] = NONE;
+        next[v] = head[score[v]];
+        if (next[v] != NONE) prev[next[v]] = v;
+        head[score[v]] = v;
+    };
+    auto bump = [&](Vertex u, bool up) {
+        if (placed[u]) return;
+        unlink(u);
+        if (up) max_score = std::max(max_score, ++score[u]);
+        else --score[u];
+        link(u);
+    };
+    // v entering (up) or leaving the window changes the score of its neighbors and of their neighbors
+    auto touch = [&](Vertex v, bool up) {
+        for (size_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+            Vertex x = adj[k];
+            bump(x, up);
+            if (offsets[x + 1] - offsets[x] > hub) continue;
+            for (size_t j = offsets[x]; j < offsets[x + 1]; ++j) {
+                if (adj[j] != v) bump(adj[j], up);
+            }
+        }
+    };
+
+    for (Vertex v = n; v-- > 0;) link(v);
+
+    // Start from the highest degree Vertex, as in the paper
+    Vertex v = 0;
+    for (Vertex u = 1; u < n; ++u) {
+        if (offsets[u + 1] - offsets[u] > offsets[v + 1] - offsets[v]) v = u;
+    }
+
+    vector<Vertex> order;
+    order.reserve(n);
+    while (true) {
+        unlink(v);
+        placed[v] = true;
+        order.push_back(v);
+        touch(v, true);
+        if (order.size() > window) touch(order[order.size() - 1 - window], false);
+        if (order.size() == n) break;
+
+        while (head[max_score] == NONE) max_score--;
+        v = head[max_score];
+    }
+    return inverse(order);
+}
+
+vector<Vertex> Reorder::inverse(const vector<Vertex>& new_id) {
+    vector<Vertex> old_id(new_id.size());
+    for (Vertex v = 0; v < new_id.size(); ++v) old_id[new_id[v]] = v;
+    return old_id;
+}
+
+#define INSTANTIATE_REORDER(W, D) \
+    template vector<Vertex> Reorder::byDegree(const BasicGraph<W, D>& g); \
+    template vector<Vertex> Reorder::reverseCuthillMcKee(const BasicGraph<W, D>& g); \
+    template vector<Vertex> Reorder::gorder(const BasicGraph<W, D>& g, size_t window);
+FOR_EACH_BASIC_GRAPH(INSTANTIATE_REORDER)
+#undef INSTANTIATE_REORDER
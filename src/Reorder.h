@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "Graph.h"
+
+using std::vector;
+
+/**
+ * Vertex orderings that put Vertices which are traversed together next to each other, so BFS, DFS and
+ * neighbor-intersection kernels touch fewer cache lines. Each one returns a permutation new_id, where
+ * Vertex v becomes new_id[v]; apply it with Graph::reorder(), and with IdMap::permute() to keep reporting
+ * results in the original ids. Directed Graphs are ordered by their underlying undirected Graph.
+ * Works on every BasicGraph instantiation.
+ */
+class Reorder {
+public:
+    /**
+     * @brief Sorts the Vertices by degree, highest first, so the hubs most traversals go through share a
+     * few cache lines. Ties keep their current order.
+     *
+     * @param g Graph to order
+     * @return vector<Vertex> new_id of every Vertex
+     */
+    template <typename GraphT>
+    static vector<Vertex> byDegree(const GraphT& g);
+
+    /**
+     * @brief Reverse Cuthill-McKee: a BFS from a low degree Vertex of each connected component, visiting
+     * neighbors by increasing degree, then reversed. Neighbors end up with nearby ids, which keeps the
+     * adjacency matrix close to the diagonal (small bandwidth).
+     *
+     * @param g Graph to order
+     * @return vector<Vertex> new_id of every Vertex
+     */
+    template <typename GraphT>
+    static vector<Vertex> reverseCuthillMcKee(const GraphT& g);
+
+    /**
+     * @brief Gorder (Wei et al., SIGMOD 2016): greedily places next the Vertex with the most neighbors and
+     * common neighbors among the last window placed Vertices. Scores only change by one at a time, so they
+     * are kept in score buckets instead of a heap. Vertices with more than sqrt(n) neighbors are not
+     * expanded for common neighbors, which keeps hubs from dominating the running time.
+     *
+     * @param g Graph to order
+     * @param window Number of recently placed Vertices a candidate is scored against
+     * @return vector<Vertex> new_id of every Vertex
+     */
+    template <typename GraphT>
+    static vector<Vertex> gorder(const GraphT& g, size_t window = 5);
+
+    /**
+     * @brief Inverts a permutation, e.g. to turn a new_id back into the original ids, or to list the
+     * Vertices in their new order
+     *
+     * @param new_id Permutation of 0..n-1
+     * @return vector<Vertex> old id of every new id
+     */
+    static vector<Vertex> inverse(const vector<Vertex>& new_id);
+
+private:
+    /**
+     * @brief Helper function: Builds the underlying undirected Graph of g as CSR arrays (union of
+     * outgoing and incoming Edges, without self loops)
+     */
+    template <typename GraphT>
+    static void undirected(const GraphT& g, vector<size_t>& offsets, vector<Vertex>& adj);
+};
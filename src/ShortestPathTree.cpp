@@ -0,0 +1,17 @@
+#include <algorithm>
+
+#include "ShortestPathTree.h"
+
+const Vertex ShortestPathTree::NONE;
+
+ShortestPathTree::ShortestPathTree(Vertex source, size_t n)
+    : source_(source), parent_(n, NONE), distance_(n, infinity()) {}
+
+vector<Vertex> ShortestPathTree::pathTo(Vertex target) const {
+    vector<Vertex> path;
+    if (!reaches(target))
+        return path;
+    for (Vertex v = target; v != NONE; v = parent_[v]) path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::vector;
+
+typedef size_t Vertex;
+
+/**
+ * The shortest paths from one source to every Vertex, as a parent array: each reachable Vertex
+ * stores the Vertex before it on a shortest path, and its distance. Any path is then read back
+ * from its target in O(path length). Built by BasicGraph::shortestPathTree (hops), or dijkstra and
+ * deltaStepping (summed weights).
+ */
+class ShortestPathTree {
+    public:
+        /**
+         * @brief Parent of the source and of unreachable Vertices
+         */
+        static const Vertex NONE = Vertex(-1);
+
+        /**
+         * @brief Construct a tree over n Vertices where nothing is reachable yet, not even source
+         */
+        ShortestPathTree(Vertex source = NONE, size_t n = 0);
+
+        /**
+         * @brief Records that v is reachable at distance, through parent. Used by the searches building the tree.
+         */
+        inline void reach(Vertex v, Vertex parent, double distance) {
+            parent_[v] = parent;
+            distance_[v] = distance;
+        }
+
+        /**
+         * @brief Vertex the paths start from
+         */
+        inline Vertex source() const { return source_; }
+
+        /**
+         * @brief Number of Vertices in the Graph the tree was built on
+         */
+        inline size_t size() const { return parent_.size(); }
+
+        /**
+         * @brief If there is a path from the source to v
+         */
+        inline bool reaches(Vertex v) const { return v < size() && distance_[v] != infinity(); }
+
+        /**
+         * @brief Vertex before v on its shortest path, NONE for the source and unreachable Vertices
+         */
+        inline Vertex parent(Vertex v) const { return v < size() ? parent_[v] : NONE; }
+
+        /**
+         * @brief Length of the shortest path to v (in Edges, or summed weights), infinity() if there is none
+         */
+        inline double distance(Vertex v) const { return v < size() ? distance_[v] : infinity(); }
+
+        /**
+         * @brief A shortest path from the source to target, following parents back. O(path length).
+         *
+         * @param target Vertex the path ends at
+         * @return vector<Vertex> The path, source and target included. Empty if target is unreachable.
+         */
+        vector<Vertex> pathTo(Vertex target) const;
+
+        /**
+         * @brief Distance of unreachable Vertices
+         */
+        static inline double infinity() { return std::numeric_limits<double>::infinity(); }
+
+    private:
+        Vertex source_;
+        vector<Vertex> parent_;
+        vector<double> distance_;
+};
+
+/**
+ * Keeps the ShortestPathTrees of the last few sources queried, so repeated queries from the same
+ * source only cost the path reconstruction. Least recently used trees are dropped first; each one
+ * takes 16 bytes per Vertex.
+ *
+ * The cache cannot see the Graph change: call clear() after changeWeight(), reorder() or anything
+ * else that changes its Edges.
+ */
+template <typename GraphT>
+class ShortestPathCache {
+    public:
+        /**
+         * @brief Construct an empty cache
+         *
+         * @param g Graph to build the trees on. Must outlive the cache.
+         * @param capacity Most trees kept at a time
+         * @param weighted If true, the trees come from dijkstra() and follow weights; otherwise from
+         * shortestPathTree() and count Edges
+         */
+        ShortestPathCache(const GraphT& g, size_t capacity, bool weighted = false)
+            : g_(g), capacity_(capacity ? capacity : 1), weighted_(weighted) {}
+
+        /**
+         * @brief The tree from source, built on the first query and reused after. Shared with the cache, so it
+         * stays valid after the cache drops it.
+         */
+        std::shared_ptr<const ShortestPathTree> tree(Vertex source) {
+            auto found = index_.find(source);
+            if (found != index_.end()) {
+                // most recently used goes first
+                trees_.splice(trees_.begin(), trees_, found->second);
+                return trees_.front();
+            }
+            if (trees_.size() == capacity_) {
+                index_.erase(trees_.back()->source());
+                trees_.pop_back();
+            }
+            trees_.push_front(std::make_shared<const ShortestPathTree>(weighted_ ? g_.dijkstra(source) : g_.shortestPathTree(source)));
+            index_[source] = trees_.begin();
+            return trees_.front();
+        }
+
+        /**
+         * @brief A shortest path from source to target, source and target included, empty if there is none
+         */
+        inline vector<Vertex> path(Vertex source, Vertex target) { return tree(source)->pathTo(target); }
+
+        /**
+         * @brief Number of trees kept
+         */
+        inline size_t size() const { return trees_.size(); }
+
+        /**
+         * @brief Drops every tree, e.g. after the Graph changed
+         */
+        inline void clear() {
+            trees_.clear();
+            index_.clear();
+        }
+
+    private:
+        const GraphT& g_;
+        size_t capacity_;
+        bool weighted_;
+
+        /**
+         * @brief The trees, most recently used first, and where each source's tree is in that list
+         */
+        std::list<std::shared_ptr<const ShortestPathTree>> trees_;
+        std::unordered_map<Vertex, typename std::list<std::shared_ptr<const ShortestPathTree>>::iterator> index_;
+};
@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned num_threads) : job_(nullptr), generation_(0), busy_(0), stop_(false) {
+    if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned w = 1; w < num_threads; ++w) threads_.emplace_back(&ThreadPool::work, this, w);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& t : threads_) t.join();
+}
+
+void ThreadPool::run(const std::function<void(unsigned)>& fn) {
+    if (threads_.empty()) {
+        fn(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        busy_ = unsigned(threads_.size());
+        generation_++;
+    }
+    start_.notify_all();
+
+    fn(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::work(unsigned worker) {
+    size_t seen = 0;
+    while (true) {
+        const std::function<void(unsigned)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            job = job_;
+        }
+
+        (*job)(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_ == 0) done_.notify_one();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+/**
+ * A fixed set of worker threads, started once and reused, for running one job on every worker at
+ * a time (e.g. one BFS level). The calling thread takes part as worker 0, so a pool of size 1
+ * starts no threads at all.
+ */
+class ThreadPool {
+    public:
+        /**
+         * @brief Starts the workers
+         *
+         * @param num_threads Number of workers, including the calling thread. 0 picks std::thread::hardware_concurrency().
+         */
+        explicit ThreadPool(unsigned num_threads = 0);
+
+        /**
+         * @brief Stops and joins the workers
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Number of workers, including the calling thread
+         */
+        inline unsigned size() const { return unsigned(threads_.size()) + 1; }
+
+        /**
+         * @brief Runs fn(worker) once on every worker, 0..size()-1, and waits for all of them
+         */
+        void run(const std::function<void(unsigned)>& fn);
+
+        /**
+         * @brief Splits 0..count-1 into size() contiguous chunks, in worker order, and runs
+         * fn(worker, begin, end) on each. Waits for all of them.
+         */
+        template <typename Fn>
+        void parallelFor(size_t count, Fn fn) {
+            unsigned workers = size();
+            run([count, workers, &fn](unsigned w) { fn(w, count * w / workers, count * (w + 1) / workers); });
+        }
+
+    private:
+        vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable start_, done_;
+
+        /**
+         * @brief Current job, and how many times a job has been started (so workers notice a new one)
+         */
+        const std::function<void(unsigned)>* job_;
+        size_t generation_;
+
+        /**
+         * @brief Workers still running the current job
+         */
+        unsigned busy_;
+        bool stop_;
+
+        /**
+         * @brief Helper function: Loop run by every worker thread
+         */
+        void work(unsigned worker);
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "TraversalWorkspace.h"
+
+using std::vector;
+
+/**
+ * One Vertex produced by a traversal range, and how far from the start it was found: the BFS level,
+ * or the depth in the DFS tree.
+ */
+struct TraversalStep {
+    Vertex vertex;
+    int depth;
+};
+
+/**
+ * Input iterator over a traversal range (BreadthFirstRange or DepthFirstRange). Incrementing it runs
+ * the traversal just far enough to find the next Vertex. All iterators of a range share its state, so
+ * only one pass is possible.
+ */
+template <typename Range>
+class TraversalIterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef TraversalStep value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const TraversalStep* pointer;
+        typedef const TraversalStep& reference;
+
+        /**
+         * @brief Construct the end iterator, or one at the current step of range
+         */
+        explicit TraversalIterator(Range* range = nullptr) : range_(range) {}
+
+        inline const TraversalStep& operator*() const { return range_->current_; }
+        inline const TraversalStep* operator->() const { return &range_->current_; }
+
+        inline TraversalIterator& operator++() {
+            if (!range_->advance()) range_ = nullptr;
+            return *this;
+        }
+
+        inline bool operator==(const TraversalIterator& other) const { return range_ == other.range_; }
+        inline bool operator!=(const TraversalIterator& other) const { return range_ != other.range_; }
+
+    private:
+        Range* range_;
+};
+
+/**
+ * A BFS that runs as it is iterated: each Vertex is only expanded once the iteration needs what it
+ * queues, so a caller that stops after the first k Vertices (or at a condition) only pays for
+ * those. Visits in the same order as BasicGraph::BFS. Get one from BasicGraph::bfsRange().
+ *
+ * The queue and visited marks are in the TraversalWorkspace, which must outlive the range and not be
+ * used for anything else meanwhile.
+ */
+template <typename GraphT>
+class BreadthFirstRange {
+    public:
+        typedef TraversalIterator<BreadthFirstRange> iterator;
+
+        /**
+         * @brief Starts the BFS from start, resetting ws. A start outside the Graph makes an empty range.
+         */
+        BreadthFirstRange(const GraphT& g, Vertex start, TraversalWorkspace& ws) : g_(&g), ws_(&ws), next_(0), expanded_(0) {
+            ws.reset(g.getSize());
+            ws.queue().clear();
+            if (start < g.getSize()) {
+                ws.visit(start);
+                ws.queue().push_back(start);
+            }
+            done_ = !advance();
+        }
+
+        BreadthFirstRange(BreadthFirstRange&&) = default;
+        BreadthFirstRange(const BreadthFirstRange&) = delete;
+        BreadthFirstRange& operator=(const BreadthFirstRange&) = delete;
+
+        inline iterator begin() { return iterator(done_ ? nullptr : this); }
+        inline iterator end() { return iterator(); }
+
+    private:
+        friend class TraversalIterator<BreadthFirstRange>;
+
+        const GraphT* g_;
+        TraversalWorkspace* ws_;
+
+        /**
+         * @brief Position in the queue of the next Vertex to produce, and of the next one to expand
+         */
+        size_t next_, expanded_;
+        TraversalStep current_;
+        bool done_;
+
+        /**
+         * @brief Helper function: Moves current_ to the next Vertex, expanding queued ones until there is
+         * one. Returns false once the traversal is over.
+         */
+        bool advance() {
+            vector<Vertex>& queue = ws_->queue();
+            while (next_ == queue.size() && expanded_ < queue.size()) {
+                Vertex v = queue[expanded_++];
+                int depth = ws_->distance(v) + 1;
+                for (Vertex u : g_->neighbors(v)) {
+                    if (ws_->visit(u, v, depth)) queue.push_back(u);
+                }
+            }
+            if (next_ == queue.size())
+                return false;
+            current_.vertex = queue[next_++];
+            current_.depth = ws_->distance(current_.vertex);
+            return true;
+        }
+};
+
+/**
+ * A DFS that runs as it is iterated, one step of the explicit stack at a time, producing Vertices in
+ * the same (pre)order as BasicGraph::DFS. Get one from BasicGraph::dfsRange().
+ *
+ * The visited marks are in the TraversalWorkspace, which must outlive the range and not be used for
+ * anything else meanwhile. The stack only holds the current path.
+ */
+template <typename GraphT>
+class DepthFirstRange {
+    public:
+        typedef TraversalIterator<DepthFirstRange> iterator;
+
+        /**
+         * @brief Starts the DFS from start, resetting ws. A start outside the Graph makes an empty range.
+         */
+        DepthFirstRange(const GraphT& g, Vertex start, TraversalWorkspace& ws) : g_(&g), ws_(&ws) {
+            ws.reset(g.getSize());
+            done_ = start >= g.getSize();
+            if (done_)
+                return;
+            ws.visit(start);
+            stack_.emplace_back(start, 0);
+            current_.vertex = start;
+            current_.depth = 0;
+        }
+
+        DepthFirstRange(DepthFirstRange&&) = default;
+        DepthFirstRange(const DepthFirstRange&) = delete;
+        DepthFirstRange& operator=(const DepthFirstRange&) = delete;
+
+        inline iterator begin() { return iterator(done_ ? nullptr : this); }
+        inline iterator end() { return iterator(); }
+
+    private:
+        friend class TraversalIterator<DepthFirstRange>;
+
+        const GraphT* g_;
+        TraversalWorkspace* ws_;
+
+        /**
+         * @brief The current path, as (Vertex, next neighbor to look at) frames
+         */
+        vector<std::pair<Vertex, size_t>> stack_;
+        TraversalStep current_;
+        bool done_;
+
+        /**
+         * @brief Helper function: Moves current_ to the next Vertex, backtracking as needed. Returns false
+         * once the traversal is over.
+         */
+        bool advance() {
+            while (!stack_.empty()) {
+                Vertex v = stack_.back().first;
+                auto adj = g_->neighbors(v);
+                size_t next = stack_.back().second;
+                int depth = int(stack_.size());
+                while (next < adj.size() && !ws_->visit(adj[next], v, depth)) ++next;
+                if (next == adj.size()) {
+                    stack_.pop_back();
+                    continue;
+                }
+                stack_.back().second = next + 1;
+                stack_.emplace_back(adj[next], 0);
+                current_.vertex = adj[next];
+                current_.depth = depth;
+                return true;
+            }
+            return false;
+        }
+};
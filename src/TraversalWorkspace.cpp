@@ -0,0 +1,22 @@
+#include <algorithm>
+
+#include "TraversalWorkspace.h"
+
+const Vertex TraversalWorkspace::NONE;
+
+TraversalWorkspace::TraversalWorkspace(size_t n) : epoch_(0) {
+    reset(n);
+}
+
+void TraversalWorkspace::reset(size_t n) {
+    if (n > stamp_.size()) {
+        stamp_.assign(n, 0);
+        parent_.resize(n);
+        distance_.resize(n);
+        epoch_ = 0;
+    }
+    if (++epoch_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        epoch_ = 1;
+    }
+}
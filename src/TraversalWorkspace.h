@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+typedef size_t Vertex;
+
+/**
+ * Scratch memory for traversals, kept from one traversal to the next: a visited mark, parent and
+ * distance for every Vertex, and a queue. Marks are stamped with the number of the current traversal
+ * (its epoch), so starting a new one only bumps the epoch instead of clearing O(V) memory. The
+ * arrays are only cleared when they have to grow, or once every 2^32 traversals when the epoch wraps
+ * around. This is what makes thousands of small queries (a few hops around one Vertex) cheap.
+ *
+ * Not thread safe: use one workspace per thread.
+ */
+class TraversalWorkspace {
+    public:
+        /**
+         * @brief Parent of the starting Vertex and of unvisited ones
+         */
+        static const Vertex NONE = Vertex(-1);
+
+        /**
+         * @brief Construct a workspace, ready for a traversal of a Graph with n Vertices
+         */
+        explicit TraversalWorkspace(size_t n = 0);
+
+        /**
+         * @brief Starts a new traversal of a Graph with n Vertices: every Vertex is unvisited again.
+         * O(1) unless n is larger than any Graph this workspace has seen.
+         */
+        void reset(size_t n);
+
+        /**
+         * @brief Number of Vertices the arrays currently have room for
+         */
+        inline size_t size() const { return stamp_.size(); }
+
+        /**
+         * @brief If v has been visited in the current traversal
+         */
+        inline bool visited(Vertex v) const { return stamp_[v] == epoch_; }
+
+        /**
+         * @brief Marks v as visited, if it was not already
+         *
+         * @param v Vertex to mark
+         * @param parent Vertex v was reached from
+         * @param distance Number of Edges from the start, or depth in a DFS
+         * @return bool True if v was not visited before (and parent and distance were recorded)
+         */
+        inline bool visit(Vertex v, Vertex parent = NONE, int distance = 0) {
+            if (stamp_[v] == epoch_)
+                return false;
+            stamp_[v] = epoch_;
+            parent_[v] = parent;
+            distance_[v] = distance;
+            return true;
+        }
+
+        /**
+         * @brief Vertex v was reached from, NONE if v is the start or has not been visited
+         */
+        inline Vertex parent(Vertex v) const { return visited(v) ? parent_[v] : NONE; }
+
+        /**
+         * @brief Distance of v recorded by visit(), -1 if v has not been visited
+         */
+        inline int distance(Vertex v) const { return visited(v) ? distance_[v] : -1; }
+
+        /**
+         * @brief Queue (or stack) for the traversal to use. Not cleared by reset(), so its capacity is reused.
+         */
+        inline vector<Vertex>& queue() { return queue_; }
+
+    private:
+        vector<uint32_t> stamp_;
+        vector<Vertex> parent_;
+        vector<int> distance_;
+        vector<Vertex> queue_;
+
+        /**
+         * @brief Stamp of the current traversal. 0 never is one, so zeroed stamps are unvisited.
+         */
+        uint32_t epoch_;
+};
@@ -1,9 +1,17 @@
+#include <algorithm>
 #include <string>
 #include <vector>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
 
 #include "catch.hpp"
+#include "../src/DaryHeap.h"
 #include "../src/FileReader.h"
 #include "../src/Graph.h"
+#include "../src/Reorder.h"
+#include "../src/ThreadPool.h"
+#include "../src/TraversalWorkspace.h"
 
 /************************************** Tests for Graph Set-Up **************************************/
 
@@ -32,6 +40,70 @@ TEST_CASE("Simple FileReader test", "[filereader]") {
 	for (size_t i = 0; i < lines.size(); ++i) REQUIRE(lines[i] == ans[i]);
 }
 
+TEST_CASE("Mapped FileReader test", "[filereader][mmap]") {
+	vector<uint64_t> ids = FileReader::fileToIds("tests/test_data_simple.txt");
+	REQUIRE(ids == vector<uint64_t>({0, 1, 0, 2, 2, 3}));
+
+	// comments, blank lines, tabs and CRLF
+	string text = "# FromNodeId\tToNodeId\r\n0\t12\r\n\n% another\n18446744073709551615 5";
+	ids.clear();
+	FileReader::parseIds(text.data(), text.data() + text.size(), ids);
+	REQUIRE(ids == vector<uint64_t>({0, 12, 18446744073709551615ULL, 5}));
+
+	// a junk token or a missing id drops its whole line, extra columns are ignored
+	text = "1 2\n7 x9 3\nx 4\n9\n5 6 1217567877 0.5\n3 4 x\n8 7";
+	ids.clear();
+	FileReader::parseIds(text.data(), text.data() + text.size(), ids);
+	REQUIRE(ids == vector<uint64_t>({1, 2, 5, 6, 3, 4, 8, 7}));
+
+	// ids past 2^64 - 1 drop their line too, whether they overflow in the 8-digit chunks or the last digits
+	text = "18446744073709551615 1\n18446744073709551616 2\n3 123456789012345678901234\n"
+	       "00000000000000000000000000042 4\n99999999999999999999 5\n6 7";
+	ids.clear();
+	FileReader::parseIds(text.data(), text.data() + text.size(), ids);
+	REQUIRE(ids == vector<uint64_t>({18446744073709551615ULL, 1, 42, 4, 6, 7}));
+
+	REQUIRE(FileReader::fileToIds("tests/does_not_exist.txt").empty());
+}
+
+TEST_CASE("SWAR digit parsing", "[filereader][swar]") {
+	const char* text = "12345678 9876543210\n4039 0000000000";
+	REQUIRE(FileReader::leadingDigits(text) == 8);
+	REQUIRE(FileReader::parseDigits(text, 8) == 12345678);
+	REQUIRE(FileReader::parseDigits(text, 3) == 123);
+	REQUIRE(FileReader::leadingDigits(text + 5) == 3);
+	REQUIRE(FileReader::leadingDigits(text + 8) == 0);
+	REQUIRE(FileReader::leadingDigits(text + 20) == 4);
+	REQUIRE(FileReader::parseDigits(text + 20, 4) == 4039);
+
+	vector<uint64_t> ids;
+	FileReader::parseIds(text, text + std::strlen(text), ids);
+	REQUIRE(ids == vector<uint64_t>({12345678, 9876543210ULL, 4039, 0}));
+}
+
+TEST_CASE("Parallel FileReader matches sequential", "[filereader][mmap][parallel]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	REQUIRE(ids.size() == 2 * 88234);
+
+	for (unsigned threads : {0u, 1u, 2u, 3u, 8u}) {
+		INFO("threads = " + std::to_string(threads));
+		REQUIRE(FileReader::fileToIdsParallel("data/facebook_combined.txt", threads) == ids);
+	}
+	REQUIRE(FileReader::fileToIdsParallel("tests/test_data_simple.txt", 4) == vector<uint64_t>({0, 1, 0, 2, 2, 3}));
+	REQUIRE(FileReader::fileToIdsParallel("tests/does_not_exist.txt", 4).empty());
+}
+
+TEST_CASE("Graph Constructor test - from ids matches from strings", "[graph][constructor][filereader][mmap]") {
+	vector<string> lines = FileReader::fileToVector("data/facebook_combined.txt");
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	REQUIRE(ids.size() == lines.size());
+
+	Graph from_lines = Graph(lines, true), from_ids = Graph(ids, true);
+	REQUIRE(from_lines == from_ids);
+	REQUIRE(from_ids.getSize() == 4039);
+	REQUIRE(from_ids.get_vertices() == from_lines.get_vertices());
+}
+
 TEST_CASE("Simple Graph Constructor test - from FileReader", "[graph][constructor][filereader][directed]") {
 	vector<string> lines = FileReader::fileToVector("tests/test_data_simple.txt");
 
@@ -109,6 +181,421 @@ TEST_CASE("Simple Graph Function test", "[graph][functions][directed]") {
 	REQUIRE(single_dir.getWeight(0, 1) == 0.1234);
 }
 
+TEST_CASE("Graph changeWeight adds and removes Edges", "[graph][functions][csr]") {
+	vector<Graph::Edge> edges;
+
+	// repeated Edge keeps the last weight given
+	edges.emplace_back(0, 2), edges.emplace_back(2, 3), edges.emplace_back(0, 2, 5.0);
+
+	Graph g = Graph(edges, 4, false);
+	REQUIRE(g.getEdgeCount() == 2);
+	REQUIRE(g.getWeight(0, 2) == 5.0);
+
+	g.changeWeight(0, 1, 2.5);
+	g.changeWeight(3, 0, 1.0);
+	REQUIRE(g.getEdgeCount() == 4);
+	REQUIRE(g.getWeight(0, 1) == 2.5);
+	REQUIRE(g.getOutgoingEdges(0).size() == 2);
+	REQUIRE(g.getOutgoingEdges(0)[0] == Graph::Edge(0, 1, 2.5));
+	REQUIRE(g.getIncomingEdges(0).size() == 1);
+
+	g.changeWeight(0, 2, 0);
+	REQUIRE(!g.areConnected(0, 2));
+	REQUIRE(g.getEdgeCount() == 3);
+
+	vector<vector<double>> expected = { {0, 2.5, 0, 0},
+										{0, 0, 0, 0},
+										{0, 0, 0, 1},
+										{1, 0, 0, 0}
+									  };
+	REQUIRE(g.getAdjacencyMatrix() == expected);
+}
+
+TEST_CASE("Graph incoming Edges index", "[graph][functions][csr][directed]") {
+	vector<string> lines = FileReader::fileToVector("tests/test_data_complex_path.txt");
+	Graph single_dir = Graph(lines, false), double_dir = Graph(lines, true);
+
+	vector<Graph::Edge> incoming = single_dir.getIncomingEdges(6), expected = {Graph::Edge(2, 6), Graph::Edge(5, 6)};
+	REQUIRE(incoming == expected);
+	REQUIRE(single_dir.getInDegree(6) == 2);
+	REQUIRE(single_dir.getOutDegree(6) == 0);
+	REQUIRE(single_dir.getInDegree(0) == 0);
+
+	// one-way change on a double directed Graph splits the incoming index off
+	REQUIRE(double_dir.getInDegree(6) == 2);
+	double_dir.changeWeight(6, 2, 0);
+	double_dir.changeWeight(6, 4, 3.0);
+	expected = {Graph::Edge(2, 6), Graph::Edge(5, 6)};
+	REQUIRE(double_dir.getIncomingEdges(6) == expected);
+	expected = {Graph::Edge(3, 4), Graph::Edge(6, 4, 3.0)};
+	REQUIRE(double_dir.getIncomingEdges(4) == expected);
+	REQUIRE(double_dir.getIncomingEdges(2).size() == 1);
+}
+
+TEST_CASE("Neighbor views match the Edge lists", "[graph][functions][csr]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		g.changeWeight(0, 1, 0.5);
+		for (Vertex v = 0; v < g.getSize(); v++) {
+			vector<Graph::Edge> out = g.getOutgoingEdges(v), in = g.getIncomingEdges(v);
+			Graph::Neighbors adj = g.neighbors(v), in_adj = g.inNeighbors(v);
+			REQUIRE(adj.size() == out.size());
+			REQUIRE(in_adj.size() == in.size());
+			for (size_t i = 0; i < adj.size(); i++) REQUIRE((adj[i] == out[i].end && adj.weight(i) == out[i].weight));
+			for (size_t i = 0; i < in_adj.size(); i++) REQUIRE((in_adj[i] == in[i].start && in_adj.weight(i) == in[i].weight));
+		}
+		REQUIRE((g.neighbors(0)[0] == 1 && g.neighbors(0).weight(0) == 0.5));
+		REQUIRE(g.inNeighbors(1).weight(0) == 0.5);
+	}
+
+	Graph g(ids, true);
+	REQUIRE(g.neighbors(4039).empty());
+	REQUIRE(g.inNeighbors(-1).empty());
+	size_t count = 0;
+	for (Vertex u : g.neighbors(107)) count += u != 107;
+	REQUIRE(count == g.getOutDegree(107));
+}
+
+TEST_CASE("Bit matrix matches CSR", "[graph][functions][bitmatrix]") {
+	vector<string> lines = FileReader::fileToVector("tests/test_data_abitlesssimple.txt");
+	Graph csr = Graph(lines, true), bits = Graph(lines, true);
+
+	REQUIRE(bits.useBitMatrix());
+	REQUIRE(bits.hasBitMatrix());
+	REQUIRE(bits.getBitMatrix().neighbors(11) == vector<size_t>({10, 36, 99}));
+	REQUIRE(bits.getBitMatrix().rowCount(0) == 2);
+
+	// common neighbors, both kernels
+	REQUIRE(csr.countCommonNeighbors(10, 36) == 1);
+	REQUIRE(bits.countCommonNeighbors(10, 36) == 1);
+	REQUIRE(csr.countCommonNeighbors(0, 3) == bits.countCommonNeighbors(0, 3));
+
+	// same traversal order either way
+	REQUIRE(csr.BFS(0, csr) == bits.BFS(0, bits));
+	REQUIRE(csr.BFS(11, csr) == bits.BFS(11, bits));
+	REQUIRE(csr.Search_BFS(0, 36, csr) == bits.Search_BFS(0, 36, bits));
+
+	// changeWeight keeps the bits in sync
+	bits.changeWeight(0, 99, 1.0);
+	REQUIRE(bits.getBitMatrix().test(0, 99));
+	bits.changeWeight(0, 99, 0);
+	REQUIRE(!bits.getBitMatrix().test(0, 99));
+
+	// weighted graphs can't use it
+	csr.changeWeight(0, 1, 2.0);
+	REQUIRE(!csr.useBitMatrix());
+}
+
+TEST_CASE("Bit matrix frontier expansion", "[bitmatrix]") {
+	BitMatrix m(70);
+	m.set(0, 1), m.set(0, 65), m.set(1, 2), m.set(65, 69), m.set(65, 0);
+
+	vector<uint64_t> frontier(m.wordsPerRow(), 0), visited(m.wordsPerRow(), 0), next;
+	frontier[0] = visited[0] = 1;
+
+	m.expandFrontier(frontier, visited, next);
+	REQUIRE(next[0] == 2);
+	REQUIRE(next[1] == 2);
+
+	m.expandFrontier(next, visited, frontier);
+	REQUIRE(frontier[0] == 4);
+	REQUIRE(frontier[1] == (uint64_t(1) << 5));
+}
+
+TEST_CASE("Graph snapshot round trip", "[graph][snapshot]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	string path = "tests/test_output.snapshot";
+
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		g.changeWeight(0, 1, 0.5);
+		REQUIRE(g.saveSnapshot(path));
+
+		Graph loaded;
+		REQUIRE(loaded.getSize() == 0);
+		REQUIRE(loaded.loadSnapshot(path));
+		REQUIRE(loaded == g);
+		REQUIRE(loaded.getSize() == 4039);
+		REQUIRE(loaded.getWeight(0, 1) == 0.5);
+		REQUIRE(loaded.getIncomingEdges(1) == g.getIncomingEdges(1));
+		REQUIRE(loaded.get_vertices() == g.get_vertices());
+		REQUIRE(loaded.BFS(0, loaded) == g.BFS(0, g));
+
+		// editing a mapped Graph copies it out of the mapping first
+		Graph copy = loaded;
+		loaded.changeWeight(0, 1, 0);
+		REQUIRE(!loaded.areConnected(0, 1));
+		REQUIRE(copy.areConnected(0, 1));
+		REQUIRE(copy == g);
+	}
+
+	// corrupt one byte: the checksum catches it and the Graph is left alone
+	{
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(200);
+		file.put('\x7f');
+	}
+	Graph g;
+	REQUIRE(!g.loadSnapshot(path));
+	REQUIRE(g.getSize() == 0);
+	REQUIRE(!g.loadSnapshot("tests/test_data_simple.txt"));
+	REQUIRE(!g.loadSnapshot("tests/does_not_exist.snapshot"));
+	std::remove(path.c_str());
+
+	// without the checksum, offsets out of order or ids out of range are still refused
+	Graph simple(FileReader::fileToVector("tests/test_data_simple.txt"), false);
+	size_t header_bytes = 96, n = simple.getSize();
+	auto patched = [&](size_t word, uint64_t value) {
+		REQUIRE(simple.saveSnapshot(path));
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(std::streamoff(header_bytes + 8 * word));
+		file.write(reinterpret_cast<const char*>(&value), 8);
+	};
+	patched(0, 0);
+	REQUIRE(g.loadSnapshot(path, false));
+	REQUIRE(g == simple);
+	patched(1, 3);
+	REQUIRE(!g.loadSnapshot(path, false));
+	patched(n + 1, n);
+	REQUIRE(!g.loadSnapshot(path, false));
+	REQUIRE(!g.loadSnapshot(path));
+	// the first incoming neighbor: after the offsets, neighbors and incoming offsets (unit weights are not stored)
+	size_t in_neighbors = 2 * (n + 1) + simple.getEdgeCount();
+	patched(in_neighbors, 2);
+	REQUIRE(g.loadSnapshot(path, false));
+	patched(in_neighbors, 4039);
+	REQUIRE(!g.loadSnapshot(path, false));
+	patched(in_neighbors - 1, 2);
+	REQUIRE(!g.loadSnapshot(path, false));
+	std::remove(path.c_str());
+
+	// a snapshot saved from a text file goes stale once the text changes
+	string text = "tests/test_output_edges.txt";
+	std::ofstream(text) << "0 1\n1 2\n";
+	Graph parsed(FileReader::fileToIds(text), true);
+	REQUIRE(parsed.saveSnapshot(path, text));
+	REQUIRE(g.loadSnapshot(path, true, text));
+	REQUIRE(g == parsed);
+	std::ofstream(text) << "0 1\n1 2\n2 3\n";
+	REQUIRE(!g.loadSnapshot(path, true, text));
+	REQUIRE(g.loadSnapshot(path));
+	std::remove(text.c_str());
+	REQUIRE(!g.loadSnapshot(path, true, text));
+	REQUIRE(!parsed.saveSnapshot(path, text));
+	std::remove(path.c_str());
+}
+
+TEST_CASE("BasicGraph weight types and directedness policies", "[graph][template]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	Graph g(ids, true);
+
+	// unweighted and undirected: same Graph, no weights or incoming index stored, whatever the flag says
+	BasicGraph<bool, Undirected> u(ids, false);
+	REQUIRE(u.getEdgeCount() == g.getEdgeCount());
+	REQUIRE(u.BFS(0, u) == g.BFS(0, g));
+	REQUIRE(u.countTriangles() == g.countTriangles());
+	REQUIRE(u.getInDegree(107) == g.getInDegree(107));
+	REQUIRE(u.memoryBytes() <= g.memoryBytes());
+	u.changeWeight(0, 1, 2.5);
+	REQUIRE(u.getWeight(0, 1) == 1);
+	u.changeWeight(1, 0, 0);
+	REQUIRE(!u.areConnected(0, 1));
+	REQUIRE(!u.areConnected(1, 0));
+	u.changeWeight(3, 2000, 1);
+	REQUIRE(u.areConnected(2000, 3));
+	REQUIRE(u.getIncomingEdges(3).size() == u.getOutDegree(3));
+
+	// directed: Edges only go one way, and the incoming index is always there
+	BasicGraph<float, Directed> d(ids, true);
+	Graph single(ids, false);
+	REQUIRE(d.getEdgeCount() == single.getEdgeCount());
+	REQUIRE(d.getIncomingEdges(107) == single.getIncomingEdges(107));
+	d.changeWeight(0, 1, 0.25);
+	REQUIRE(d.getWeight(0, 1) == 0.25f);
+	REQUIRE(d.getIncomingEdges(1)[0].weight == 0.25f);
+
+	// small integer weights are clamped to 0..255, and a weight that rounds to 0 is no Edge
+	BasicGraph<uint8_t, RuntimeDirected> small(ids, true);
+	small.changeWeight(0, 1, 300);
+	small.changeWeight(0, 2, 7.9);
+	small.changeWeight(0, 3, 0.4);
+	REQUIRE(small.getWeight(0, 1) == 255);
+	REQUIRE(small.getWeight(0, 2) == 7);
+	REQUIRE(!small.areConnected(0, 3));
+	REQUIRE(small.areConnected(3, 0));
+	REQUIRE(small.getIncomingEdges(3).size() == small.getInDegree(3));
+}
+
+TEST_CASE("BasicGraph snapshots keep their weight type", "[graph][template][snapshot]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	string path = "tests/test_output.snapshot";
+
+	// 4-byte weights get padded out to whole words
+	BasicGraph<float, Directed> d(ids, false);
+	d.changeWeight(0, 1, 0.5);
+	d.changeWeight(0, 2, 1.5);
+	d.changeWeight(0, 3, 2.5);
+	REQUIRE(d.saveSnapshot(path));
+	BasicGraph<float, Directed> loaded;
+	REQUIRE(loaded.loadSnapshot(path));
+	REQUIRE(loaded == d);
+	REQUIRE(loaded.getWeight(0, 3) == 2.5f);
+	REQUIRE(loaded.getIncomingEdges(2) == d.getIncomingEdges(2));
+
+	// another weight type or shape is rejected
+	Graph g;
+	REQUIRE(!g.loadSnapshot(path));
+	BasicGraph<float, Undirected> u;
+	REQUIRE(!u.loadSnapshot(path));
+
+	BasicGraph<bool, Undirected> b(ids, true);
+	REQUIRE(b.saveSnapshot(path));
+	BasicGraph<bool, Undirected> b_loaded;
+	REQUIRE(b_loaded.loadSnapshot(path));
+	REQUIRE(b_loaded == b);
+	REQUIRE(b_loaded.countCommonNeighbors(0, 1) == b.countCommonNeighbors(0, 1));
+	std::remove(path.c_str());
+}
+
+TEST_CASE("IdMap compacts sparse numeric ids", "[idmap][constructor]") {
+	// 64-bit ids that would otherwise size the Graph in the quintillions
+	vector<uint64_t> ids = {1000000000, 7, 7, 18446744073709551615ULL, 1000000000, 18446744073709551615ULL};
+	IdMap map;
+	map.compact(ids);
+
+	REQUIRE(map.size() == 3);
+	REQUIRE(ids == vector<uint64_t>({1, 0, 0, 2, 1, 2}));
+	REQUIRE(map.toExternal(2) == 18446744073709551615ULL);
+	REQUIRE(map.toExternalString(1) == "1000000000");
+
+	Vertex v;
+	REQUIRE(map.toInternal(1000000000, v));
+	REQUIRE(v == 1);
+	REQUIRE(map.toInternal(string("7"), v));
+	REQUIRE(v == 0);
+	REQUIRE(!map.toInternal(8, v));
+	REQUIRE(!map.toInternal(string("seven"), v));
+	// only plain digits: "-1" is not 2^64 - 1, and neither is anything that wraps around to it
+	REQUIRE(map.toInternal(string("18446744073709551615"), v));
+	REQUIRE(v == 2);
+	REQUIRE(!map.toInternal(string("-1"), v));
+	REQUIRE(!map.toInternal(string(" 7"), v));
+	REQUIRE(!map.toInternal(string("+7"), v));
+	REQUIRE(!map.toInternal(string("36893488147419103231"), v));
+	REQUIRE(!map.toInternal(string(""), v));
+
+	Graph g(ids, true);
+	REQUIRE(g.getSize() == 3);
+	REQUIRE(g.areConnected(1, 0));
+	REQUIRE(g.areConnected(2, 0));
+	REQUIRE(g.areConnected(1, 2));
+
+	// relabel: the map keeps answering in external ids
+	map.permute({2, 0, 1});
+	REQUIRE(map.toInternal(7, v));
+	REQUIRE(v == 2);
+	REQUIRE(map.toExternal(0) == 1000000000);
+	REQUIRE(map.toExternal(1) == 18446744073709551615ULL);
+}
+
+TEST_CASE("IdMap string ids and dense input", "[idmap][filereader]") {
+	vector<string> tokens = {"alice", "bob", "carol", "alice", "bob", "dave"};
+	IdMap names;
+	vector<uint64_t> ids = names.compact(tokens);
+
+	REQUIRE(!names.isNumeric());
+	REQUIRE(names.size() == 4);
+	REQUIRE(ids == vector<uint64_t>({0, 1, 2, 0, 1, 3}));
+	REQUIRE(names.toExternalString(3) == "dave");
+	Vertex v;
+	REQUIRE(names.toInternal(string("carol"), v));
+	REQUIRE(v == 2);
+
+	Graph g(ids, false);
+	REQUIRE(g.getSize() == 4);
+	REQUIRE(g.areConnected(2, 0));
+
+	// ids that are already 0..n-1 map to themselves
+	vector<uint64_t> fb = FileReader::fileToIds("data/facebook_combined.txt"), original = fb;
+	IdMap map;
+	map.compact(fb);
+	REQUIRE(fb == original);
+	REQUIRE(map.size() == 4039);
+	REQUIRE(map.toExternal(4038) == 4038);
+}
+
+TEST_CASE("Reordering keeps the Graph the same up to relabeling", "[graph][reorder][idmap]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	Graph original(ids, true);
+	Graph directed(FileReader::fileToIds("tests/test_data_complex_path.txt"), false);
+	size_t triangles = original.countTriangles();
+
+	for (int method = 0; method < 3; method++) {
+		vector<Vertex> new_id = method == 0 ? Reorder::byDegree(original)
+							  : method == 1 ? Reorder::reverseCuthillMcKee(original) : Reorder::gorder(original);
+		Graph g = original;
+		REQUIRE(g.reorder(new_id));
+		REQUIRE(g.getEdgeCount() == original.getEdgeCount());
+		REQUIRE(g.countTriangles() == triangles);
+		for (Vertex v = 0; v < original.getSize(); v += 97) {
+			for (const Graph::Edge& e : original.getOutgoingEdges(v)) REQUIRE(g.areConnected(new_id[v], new_id[e.end]));
+			REQUIRE(g.BFS(new_id[v], g).size() == original.BFS(v, original).size());
+		}
+
+		// results map back to the original ids through the IdMap
+		IdMap map = IdMap::identity(original.getSize());
+		map.permute(new_id);
+		REQUIRE(map.toExternal(new_id[107]) == 107);
+
+		REQUIRE(g.reorder(Reorder::inverse(new_id)));
+		REQUIRE(g == original);
+
+		// single directed: the incoming index follows along
+		vector<Vertex> dir_id = method == 0 ? Reorder::byDegree(directed)
+							  : method == 1 ? Reorder::reverseCuthillMcKee(directed) : Reorder::gorder(directed);
+		Graph h = directed;
+		REQUIRE(h.reorder(dir_id));
+		for (Vertex v = 0; v < directed.getSize(); v++) {
+			REQUIRE(h.getInDegree(dir_id[v]) == directed.getInDegree(v));
+			for (const Graph::Edge& e : directed.getIncomingEdges(v)) REQUIRE(h.areConnected(dir_id[e.start], dir_id[v]));
+		}
+	}
+
+	Graph g = original;
+	REQUIRE(!g.reorder({0, 1, 2}));
+	REQUIRE(!g.reorder(vector<Vertex>(original.getSize(), 0)));
+	REQUIRE(g == original);
+}
+
+TEST_CASE("Triangles and Reverse Cuthill-McKee bandwidth", "[graph][reorder]") {
+	// K4: every 3 of the 4 Vertices make a triangle
+	vector<Graph::Edge> k4 = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+	REQUIRE(Graph(k4, 4, true).countTriangles() == 4);
+	REQUIRE(Graph(k4, 4, false).countTriangles() == 4);
+	vector<Graph::Edge> cycle = {{1, 0}, {2, 1}, {0, 2}};
+	REQUIRE(Graph(cycle, 3, false).countTriangles() == 0);
+
+	// a path with scrambled ids has RCM bandwidth 1: every Edge joins consecutive ids
+	vector<Vertex> scrambled = {5, 0, 7, 2, 9, 4, 1, 8, 3, 6};
+	vector<Graph::Edge> path;
+	for (size_t i = 0; i + 1 < scrambled.size(); i++) path.emplace_back(scrambled[i], scrambled[i + 1]);
+	Graph g(path, scrambled.size(), true);
+	REQUIRE(g.reorder(Reorder::reverseCuthillMcKee(g)));
+	for (Vertex v = 0; v < g.getSize(); v++) {
+		for (const Graph::Edge& e : g.getOutgoingEdges(v)) REQUIRE((e.end == v + 1 || e.end + 1 == v));
+	}
+
+	// Gorder and degree order are permutations on disconnected input too
+	Graph sparse(vector<Graph::Edge>({{0, 5}, {5, 9}}), 12, false);
+	for (const vector<Vertex>& new_id : {Reorder::gorder(sparse), Reorder::byDegree(sparse)}) {
+		vector<Vertex> sorted = new_id;
+		std::sort(sorted.begin(), sorted.end());
+		for (Vertex v = 0; v < sorted.size(); v++) REQUIRE(sorted[v] == v);
+	}
+	REQUIRE(Reorder::byDegree(sparse)[5] == 0);
+}
+
 /*********************************** Tests for Traversals (BFS and DFS) ***********************************/
 
 TEST_CASE("Simple BFS test", "[functions][directed][traversal][BFS][double-directed]") {
@@ -184,6 +671,140 @@ TEST_CASE("Full BFS test", "[functions][directed][traversal][BFS][double-directe
 	REQUIRE(path.size() == 4039);
 }
 
+/**
+ * @brief Reference BFS levels, from a plain queue over getOutgoingEdges
+ */
+vector<int> bfsLevels(const Graph& g, Vertex start) {
+	vector<int> depth(g.getSize(), -1);
+	vector<Vertex> queue = {start};
+	depth[start] = 0;
+	for (size_t head = 0; head < queue.size(); head++) {
+		for (const Graph::Edge& e : g.getOutgoingEdges(queue[head])) {
+			if (depth[e.end] == -1) {
+				depth[e.end] = depth[queue[head]] + 1;
+				queue.push_back(e.end);
+			}
+		}
+	}
+	return depth;
+}
+
+TEST_CASE("Direction-optimizing BFS levels", "[functions][directed][traversal][BFS][double-directed][single-directed]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (Vertex start : {0, 107, 1912, 4038}) {
+			vector<int> expected = bfsLevels(g, start);
+			REQUIRE(g.directionOptimizingBFS(start) == expected);
+			// always top-down, and bottom-up from the second level on
+			REQUIRE(g.directionOptimizingBFS(start, 1e-9) == expected);
+			REQUIRE(g.directionOptimizingBFS(start, 1e18, 1e18) == expected);
+		}
+	}
+
+	// the levels are the unweighted shortest path lengths
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	vector<vector<double>> fw = small.FloydWarshall();
+	for (Vertex start = 0; start < small.getSize(); start++) {
+		vector<int> depth = small.directionOptimizingBFS(start, 1e18, 1e18);
+		for (Vertex v = 0; v < small.getSize(); v++)
+			REQUIRE(depth[v] == (fw[start][v] == __INT_MAX__ ? -1 : int(fw[start][v])));
+	}
+	REQUIRE(small.directionOptimizingBFS(7) == vector<int>(7, -1));
+}
+
+TEST_CASE("Parallel BFS matches BFS", "[functions][directed][traversal][BFS][double-directed][single-directed][parallel]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (unsigned threads : {1, 2, 4}) {
+		ThreadPool pool(threads);
+		for (bool double_directed : {true, false}) {
+			Graph g(ids, double_directed);
+			for (Vertex start : {0, 107, 1912, 4038}) {
+				vector<int> expected = bfsLevels(g, start);
+				vector<int> depth;
+				REQUIRE(g.parallelBFS(start, pool, depth, true) == g.BFS(start, g));
+				REQUIRE(depth == expected);
+
+				// any order will do, as long as it goes level by level and visits everything once
+				vector<int> order = g.parallelBFS(start, pool, depth);
+				REQUIRE(depth == expected);
+				vector<int> sorted = order;
+				std::sort(sorted.begin(), sorted.end());
+				vector<int> reached = g.BFS(start, g);
+				std::sort(reached.begin(), reached.end());
+				REQUIRE(sorted == reached);
+				for (size_t i = 1; i < order.size(); i++) REQUIRE(depth[order[i - 1]] <= depth[order[i]]);
+			}
+		}
+	}
+
+	ThreadPool pool(2);
+	vector<int> depth;
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	REQUIRE(small.parallelBFS(7, pool, depth).empty());
+	REQUIRE(depth == vector<int>(7, -1));
+}
+
+TEST_CASE("Multi-source BFS, closeness and eccentricity", "[functions][directed][traversal][BFS][double-directed][single-directed][msbfs]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	vector<Vertex> sources;
+	// more than one batch of 64, with a repeat
+	for (Vertex v = 0; v < 4039; v += 29) sources.push_back(v);
+	sources.push_back(0);
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		vector<vector<int>> depth = g.multiSourceBFS(sources);
+		vector<double> close = g.closeness(sources);
+		vector<int> ecc = g.eccentricity(sources);
+		REQUIRE(depth.size() == sources.size());
+		for (size_t i = 0; i < sources.size(); i++) {
+			vector<int> expected = bfsLevels(g, sources[i]);
+			REQUIRE(depth[i] == expected);
+			size_t reached = 0, total = 0;
+			int farthest = 0;
+			for (int d : expected) {
+				if (d <= 0) continue;
+				reached++;
+				total += d;
+				farthest = std::max(farthest, d);
+			}
+			REQUIRE(close[i] == Approx(total ? double(reached) / total : 0.0));
+			REQUIRE(ecc[i] == farthest);
+		}
+	}
+
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	REQUIRE(small.multiSourceBFS({7}) == vector<vector<int>>(1, vector<int>(7, -1)));
+	REQUIRE(small.eccentricity({7}) == vector<int>(1, -1));
+	REQUIRE(small.closeness({7}) == vector<double>(1, 0.0));
+	REQUIRE(small.multiSourceBFS({}).empty());
+}
+
+TEST_CASE("Bidirectional BFS returns a shortest path", "[functions][directed][search][BFS][double-directed][single-directed]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (Vertex start : {0, 107, 1912, 4038}) {
+			vector<int> expected = bfsLevels(g, start);
+			for (Vertex end = 0; end < g.getSize(); end += 97) {
+				vector<Vertex> path = g.bidirectionalBFS(start, end);
+				if (expected[end] == -1) {
+					REQUIRE(path.empty());
+					continue;
+				}
+				REQUIRE(path.size() == size_t(expected[end]) + 1);
+				REQUIRE(path.front() == start);
+				REQUIRE(path.back() == end);
+				for (size_t i = 1; i < path.size(); i++) REQUIRE(g.getWeight(path[i - 1], path[i]) != 0);
+			}
+		}
+	}
+
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	REQUIRE(small.bidirectionalBFS(3, 3) == vector<Vertex>(1, 3));
+	REQUIRE(small.bidirectionalBFS(0, 7).empty());
+}
+
 TEST_CASE("Simple DFS test", "[functions][directed][traversal][DFS][double-directed]") {
 	// Setup Graph
 	vector<string> lines = FileReader::fileToVector("tests/test_data_abitlesssimple.txt");
@@ -277,6 +898,246 @@ TEST_CASE("FULL DFS test", "[functions][directed][traversal][DFS][double-directe
 	REQUIRE(traversal.size() == 4039);
 }
 
+void recursiveDFS(const Graph& g, Vertex v, vector<bool>& visited, vector<int>& pre, vector<int>& post) {
+	visited[v] = true;
+	pre.push_back(v);
+	for (Vertex u : g.neighbors(v))
+		if (!visited[u]) recursiveDFS(g, u, visited, pre, post);
+	post.push_back(v);
+}
+
+TEST_CASE("Iterative DFS keeps the recursive order and goes arbitrarily deep", "[functions][directed][traversal][DFS][double-directed][single-directed]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (Vertex start : {0, 107, 1000}) {
+			vector<bool> visited(g.getSize(), false);
+			vector<int> pre, post;
+			recursiveDFS(g, start, visited, pre, post);
+
+			vector<bool> seen(g.getSize(), false);
+			vector<int> got_pre, got_post;
+			REQUIRE_FALSE(g.depthFirst(start, seen, [&got_pre](Vertex v) { got_pre.push_back(v); return false; },
+			                           [&got_post](Vertex v) { got_post.push_back(v); }));
+			REQUIRE(got_pre == pre);
+			REQUIRE(got_post == post);
+			REQUIRE(seen == visited);
+		}
+	}
+
+	// a single path of 500000 Vertices, far deeper than the call stack allows
+	size_t n = 500000;
+	vector<uint64_t> path_ids;
+	for (size_t v = 0; v + 1 < n; v++) {
+		path_ids.push_back(v);
+		path_ids.push_back(v + 1);
+	}
+	Graph path(path_ids, false);
+	vector<bool> visited(n, false);
+	vector<int> traversal;
+	path.DFS(0, path, visited, traversal);
+	REQUIRE(traversal.size() == n);
+	REQUIRE(traversal.back() == int(n - 1));
+
+	visited.assign(n, false);
+	traversal.clear();
+	path.Search_DFS(0, int(n / 2), path, visited, traversal);
+	REQUIRE(traversal.size() == n / 2 + 1);
+	REQUIRE(traversal.back() == int(n / 2));
+	REQUIRE_FALSE(visited[n / 2 + 1]);
+}
+
+TEST_CASE("Traversals reuse one TraversalWorkspace", "[functions][directed][traversal][search][BFS][DFS][double-directed][single-directed][workspace]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	TraversalWorkspace ws, forward, backward;
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (Vertex start = 0; start < g.getSize(); start += 397) {
+			vector<int> expected = bfsLevels(g, start);
+			REQUIRE(g.BFS(start, ws) == g.BFS(int(start), g));
+			for (Vertex v = 0; v < g.getSize(); v++) {
+				REQUIRE(ws.distance(v) == expected[v]);
+				if (expected[v] > 0) REQUIRE(expected[ws.parent(v)] == expected[v] - 1);
+			}
+			REQUIRE(ws.parent(start) == TraversalWorkspace::NONE);
+
+			vector<bool> visited(g.getSize(), false);
+			vector<int> traversal;
+			g.DFS(int(start), g, visited, traversal);
+			REQUIRE(g.DFS(start, ws) == traversal);
+
+			Vertex end = (start * 7 + 13) % g.getSize();
+			REQUIRE(g.Search_BFS(start, end, ws) == g.Search_BFS(int(start), int(end), g));
+			visited.assign(g.getSize(), false);
+			traversal.clear();
+			g.Search_DFS(int(start), int(end), g, visited, traversal);
+			REQUIRE(g.Search_DFS(start, end, ws) == traversal);
+			REQUIRE(g.bidirectionalBFS(start, end, forward, backward) == g.bidirectionalBFS(start, end));
+		}
+	}
+
+	// a smaller Graph after a larger one, then a larger one again
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	REQUIRE(small.BFS(0, ws) == small.BFS(0, small));
+	REQUIRE_FALSE(ws.visited(100));
+	Graph path(vector<uint64_t>{0, 1, 1, 2, 2, 3}, false);
+	TraversalWorkspace tiny(2);
+	REQUIRE(path.BFS(0, tiny) == vector<int>{0, 1, 2, 3});
+	REQUIRE(tiny.distance(3) == 3);
+	REQUIRE(path.BFS(2, tiny) == vector<int>{2, 3});
+	REQUIRE_FALSE(tiny.visited(0));
+	REQUIRE(tiny.distance(0) == -1);
+}
+
+/**
+ * Labels every Vertex with the component it is found in, and counts the Edges looked at
+ */
+struct ComponentLabeler : TraversalVisitor {
+	vector<int>& label;
+	int component;
+	size_t edges, finished;
+	ComponentLabeler(vector<int>& l) : label(l), component(0), edges(0), finished(0) {}
+	void onDiscover(Vertex v, Vertex, int) { label[v] = component; }
+	bool onEdge(Vertex, Vertex) { edges++; return true; }
+	void onFinish(Vertex) { finished++; }
+};
+
+/**
+ * Only follows Edges out of Vertices less than k hops from the start, and stops at a target
+ */
+struct KHops : TraversalVisitor {
+	const TraversalWorkspace& ws;
+	int k;
+	Vertex target;
+	KHops(const TraversalWorkspace& w, int hops, Vertex t) : ws(w), k(hops), target(t) {}
+	bool onEdge(Vertex from, Vertex) { return ws.distance(from) < k; }
+	bool shouldStop(Vertex v) { return v == target; }
+};
+
+TEST_CASE("Visitors on the generic BFS and DFS", "[functions][traversal][BFS][DFS][double-directed][single-directed][visitor]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	// two components: facebook, and a triangle after it
+	for (Vertex v : {4039, 4040, 4040, 4041, 4041, 4039}) ids.push_back(v);
+	Graph g(ids, true);
+	TraversalWorkspace ws(g.getSize());
+	vector<int> label(g.getSize(), -1);
+	ComponentLabeler labeler(label);
+	for (Vertex v = 0; v < g.getSize(); v++) {
+		if (ws.visited(v)) continue;
+		g.depthFirst(v, ws, labeler);
+		labeler.component++;
+	}
+	REQUIRE(labeler.component == 2);
+	REQUIRE(labeler.edges == g.getEdgeCount());
+	REQUIRE(labeler.finished == g.getSize());
+	for (Vertex v = 0; v < 4039; v++) REQUIRE(label[v] == 0);
+	for (Vertex v = 4039; v < 4042; v++) REQUIRE(label[v] == 1);
+
+	// the BFS tree: every parent is one level up, and k-hop limits cut it off at depth k
+	vector<int> expected = bfsLevels(g, 0);
+	for (int k : {1, 2, 3}) {
+		ws.reset(g.getSize());
+		KHops hops(ws, k, TraversalWorkspace::NONE);
+		REQUIRE_FALSE(g.breadthFirst(0, ws, hops));
+		size_t within = 0;
+		for (Vertex v = 0; v < g.getSize(); v++) {
+			if (expected[v] != -1 && expected[v] <= k) within++;
+			REQUIRE(ws.distance(v) == (expected[v] <= k ? expected[v] : -1));
+			if (ws.distance(v) > 0) REQUIRE(ws.distance(ws.parent(v)) == ws.distance(v) - 1);
+		}
+		REQUIRE(ws.queue().size() == within);
+	}
+
+	// stopping: the queue ends at the target, as Search_BFS does
+	ws.reset(g.getSize());
+	KHops stop(ws, 100, 1912);
+	REQUIRE(g.breadthFirst(0, ws, stop));
+	REQUIRE(vector<int>(ws.queue().begin(), ws.queue().end()) == g.Search_BFS(0, 1912, g));
+}
+
+TEST_CASE("Lazy BFS and DFS ranges", "[functions][traversal][BFS][DFS][double-directed][single-directed][range]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	TraversalWorkspace ws;
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (Vertex start : {0, 107, 1912}) {
+			vector<int> expected = bfsLevels(g, start);
+			vector<int> order;
+			for (const TraversalStep& step : g.bfsRange(start, ws)) {
+				order.push_back(step.vertex);
+				REQUIRE(step.depth == expected[step.vertex]);
+			}
+			REQUIRE(order == g.BFS(int(start), g));
+
+			order.clear();
+			TraversalWorkspace tree;
+			g.DFS(start, tree);
+			for (const TraversalStep& step : g.dfsRange(start, ws)) {
+				order.push_back(step.vertex);
+				REQUIRE(step.depth == tree.distance(step.vertex));
+			}
+			REQUIRE(order == g.DFS(start, tree));
+
+			// the first 10 only, then the search stops
+			vector<int> first;
+			for (const TraversalStep& step : g.bfsRange(start, ws)) {
+				first.push_back(step.vertex);
+				if (first.size() == 10) break;
+			}
+			vector<int> full = g.BFS(int(start), g);
+			full.resize(std::min<size_t>(10, full.size()));
+			REQUIRE(first == full);
+		}
+	}
+
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	REQUIRE(small.bfsRange(7, ws).begin() == small.bfsRange(7, ws).end());
+	REQUIRE(small.dfsRange(100, ws).begin() == small.dfsRange(100, ws).end());
+	// a lone Vertex is a range of one
+	Graph path(vector<uint64_t>{0, 1, 2, 2}, false);
+	size_t count = 0;
+	for (const TraversalStep& step : path.dfsRange(1, ws)) {
+		REQUIRE(step.vertex == 1);
+		REQUIRE(step.depth == 0);
+		count++;
+	}
+	REQUIRE(count == 1);
+}
+
+TEST_CASE("k-hop neighborhoods", "[functions][traversal][BFS][double-directed][single-directed][khop]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	TraversalWorkspace ws;
+	vector<Vertex> sources;
+	for (Vertex v = 0; v < 4039; v += 173) sources.push_back(v);
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (int k : {0, 1, 2, 3}) {
+			vector<vector<vector<Vertex>>> batch = g.kHopNeighborhood(sources, k, ws);
+			vector<vector<size_t>> batch_counts = g.kHopCounts(sources, k, ws);
+			REQUIRE(batch.size() == sources.size());
+			for (size_t i = 0; i < sources.size(); i++) {
+				vector<int> expected = bfsLevels(g, sources[i]);
+				vector<vector<Vertex>> hops = g.kHopNeighborhood(sources[i], k, ws);
+				REQUIRE(hops.size() == size_t(k) + 1);
+				REQUIRE(hops == batch[i]);
+				vector<size_t> counts(k + 1, 0);
+				for (Vertex v = 0; v < g.getSize(); v++)
+					if (expected[v] != -1 && expected[v] <= k) counts[expected[v]]++;
+				REQUIRE(g.kHopCounts(sources[i], k, ws) == counts);
+				REQUIRE(batch_counts[i] == counts);
+				for (int d = 0; d <= k; d++) {
+					REQUIRE(hops[d].size() == counts[d]);
+					for (Vertex v : hops[d]) REQUIRE(expected[v] == d);
+				}
+			}
+		}
+	}
+
+	Graph small(FileReader::fileToVector("tests/test_data_complex_path.txt"), false);
+	REQUIRE(small.kHopNeighborhood(7, 2, ws) == vector<vector<Vertex>>(3));
+	REQUIRE(small.kHopCounts(7, 2, ws) == vector<size_t>(3, 0));
+}
+
 /*********************************** Tests for Complex Algorithm (IDDFS) ***********************************/
 TEST_CASE("Simple IDDFS", "[functions][directed][search][IDDFS][single-directed]") {
 	vector<string> lines = FileReader::fileToVector("tests/test_data_abitlesssimple.txt");
@@ -326,6 +1187,63 @@ TEST_CASE("IDDFS find nonexistent", "[functions][directed][search][IDDFS][single
 	REQUIRE(trav.size() == 0);
 }
 
+TEST_CASE("Memory-bounded IDDFS finds shortest paths", "[functions][directed][search][IDDFS][double-directed][single-directed]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (bool double_directed : {true, false}) {
+		Graph g(ids, double_directed);
+		for (Vertex start : {0, 107, 1912}) {
+			vector<int> expected = bfsLevels(g, start);
+			// no table, a tiny one that keeps colliding, and one with a slot for every Vertex
+			for (size_t table_bytes : {size_t(0), size_t(256), size_t(1) << 20}) {
+				for (Vertex end = 0; end < g.getSize(); end += 211) {
+					// without a full table it is back to exponential, so only try short paths
+					if (table_bytes < (size_t(1) << 20) && (expected[end] == -1 || expected[end] > 3)) continue;
+					vector<Vertex> path = g.boundedIddfs(start, end, 10, table_bytes);
+					if (expected[end] == -1) {
+						REQUIRE(path.empty());
+						continue;
+					}
+					REQUIRE(path.size() == size_t(expected[end]) + 1);
+					REQUIRE(path.front() == start);
+					REQUIRE(path.back() == end);
+					for (size_t i = 1; i < path.size(); i++) REQUIRE(g.getWeight(path[i - 1], path[i]) != 0);
+				}
+			}
+		}
+	}
+
+	vector<string> lines = FileReader::fileToVector("tests/test_data_abitlesssimple.txt");
+	Graph g = Graph(lines, false);
+	REQUIRE(g.boundedIddfs(0, 100, 20).empty());
+	REQUIRE(g.boundedIddfs(3, 3, 20, 1024) == vector<Vertex>(1, 3));
+	vector<int> trav = g.iddfs(0, 3, 20);
+	vector<Vertex> path = g.boundedIddfs(0, 3, 20, 1024);
+	REQUIRE(vector<int>(path.begin(), path.end()) == trav);
+}
+
+TEST_CASE("Parallel IDDFS returns the sequential path", "[functions][directed][search][IDDFS][double-directed][single-directed][parallel]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	for (unsigned threads : {1, 2, 4}) {
+		ThreadPool pool(threads);
+		for (bool double_directed : {true, false}) {
+			Graph g(ids, double_directed);
+			vector<int> expected = bfsLevels(g, 0);
+			for (Vertex end = 0; end < g.getSize(); end += 101) {
+				// iddfs is exponential in the distance, so only compare against it on short paths
+				if (expected[end] == -1 || expected[end] > 3) continue;
+				REQUIRE(g.parallelIddfs(0, int(end), 8, pool) == g.iddfs(0, int(end), 8));
+			}
+		}
+	}
+
+	ThreadPool pool(3);
+	vector<string> lines = FileReader::fileToVector("tests/test_data_abitlesssimple.txt");
+	Graph g = Graph(lines, false);
+	for (int end = 0; end < int(g.getSize()); end++) REQUIRE(g.parallelIddfs(0, end, 20, pool) == g.iddfs(0, end, 20));
+	REQUIRE(g.parallelIddfs(0, 100, 20, pool).empty());
+	REQUIRE(g.parallelIddfs(6, 100, 20, pool).empty());
+}
+
 /****************************** Tests for Shortest Path Alg (Floyd-Warshall) ******************************/
 
 /** Floyd Warshall for a Single Directed "test_simple_data" graph should look like:
@@ -441,3 +1359,186 @@ TEST_CASE("Shortest Path test complex - double directed", "[floyd-warshall][comp
 	vector<vector<double>> fw_mat = g.FloydWarshall();
 	REQUIRE(expected == fw_mat);
 }
+
+TEST_CASE("Shortest-path trees and the cache", "[functions][shortest-path][BFS][double-directed][single-directed]") {
+	for (bool double_directed : {true, false}) {
+		vector<string> lines = FileReader::fileToVector("tests/test_data_complex_path.txt");
+		Graph g(lines, double_directed);
+		vector<vector<double>> fw_mat = g.FloydWarshall();
+		for (Vertex source = 0; source < g.getSize(); source++) {
+			ShortestPathTree tree = g.shortestPathTree(source);
+			REQUIRE(tree.source() == source);
+			REQUIRE(tree.parent(source) == ShortestPathTree::NONE);
+			for (Vertex target = 0; target < g.getSize(); target++) {
+				vector<Vertex> path = tree.pathTo(target);
+				if (fw_mat[source][target] == __INT_MAX__) {
+					REQUIRE(!tree.reaches(target));
+					REQUIRE(tree.distance(target) == ShortestPathTree::infinity());
+					REQUIRE(path.empty());
+					continue;
+				}
+				REQUIRE(tree.distance(target) == fw_mat[source][target]);
+				REQUIRE(path.size() == size_t(fw_mat[source][target]) + 1);
+				REQUIRE(path.front() == source);
+				REQUIRE(path.back() == target);
+			}
+		}
+		REQUIRE(!g.shortestPathTree(g.getSize()).reaches(0));
+		REQUIRE(g.shortestPathTree(0).pathTo(g.getSize()).empty());
+	}
+
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	Graph g(ids, false);
+	TraversalWorkspace ws;
+	ShortestPathCache<Graph> cache(g, 2);
+	for (Vertex source : {0, 107, 1912}) {
+		vector<int> expected = bfsLevels(g, source);
+		ShortestPathTree tree = g.shortestPathTree(source, ws);
+		for (Vertex target = 0; target < g.getSize(); target += 37) {
+			REQUIRE(tree.reaches(target) == (expected[target] != -1));
+			if (expected[target] == -1) continue;
+			vector<Vertex> path = tree.pathTo(target);
+			REQUIRE(path.size() == size_t(expected[target]) + 1);
+			for (size_t i = 1; i < path.size(); i++) REQUIRE(g.getWeight(path[i - 1], path[i]) != 0);
+			REQUIRE(cache.path(source, target) == path);
+		}
+	}
+	// only the last two sources are kept: bringing 0 back drops 107, not the more recently used 1912
+	REQUIRE(cache.size() == 2);
+	std::shared_ptr<const ShortestPathTree> dropped = cache.tree(107), kept = cache.tree(1912);
+	cache.tree(0);
+	REQUIRE(cache.tree(1912) == kept);
+	REQUIRE(cache.tree(107) != dropped);
+	// trees handed out outlive their eviction and clear()
+	REQUIRE(dropped->source() == 107);
+	REQUIRE(dropped->pathTo(107) == vector<Vertex>(1, 107));
+	cache.clear();
+	REQUIRE(cache.size() == 0);
+	REQUIRE(kept->pathTo(0) == g.shortestPathTree(1912).pathTo(0));
+}
+
+TEST_CASE("Dijkstra and delta-stepping on weighted Graphs", "[functions][shortest-path][dijkstra][double-directed][single-directed][parallel]") {
+	vector<uint64_t> ids = FileReader::fileToIds("data/facebook_combined.txt");
+	vector<Graph::Edge> edges;
+	// small integer weights, so sums are exact and every algorithm must agree to the bit
+	for (size_t i = 0; i + 1 < ids.size(); i += 2) edges.emplace_back(ids[i], ids[i + 1], double(1 + (ids[i] * 31 + ids[i + 1] * 17) % 9));
+	for (bool double_directed : {true, false}) {
+		Graph g(edges, 4039, double_directed);
+		for (Vertex source : {0, 107, 1912}) {
+			ShortestPathTree expected = g.dijkstra(source);
+			REQUIRE(expected.distance(source) == 0);
+			for (Vertex v = 0; v < g.getSize(); v++) {
+				if (!expected.reaches(v) || v == source) continue;
+				// each parent is one Edge back, and accounts for the rest of the distance
+				Vertex parent = expected.parent(v);
+				REQUIRE(g.getWeight(parent, v) != 0);
+				REQUIRE(expected.distance(parent) + g.getWeight(parent, v) == expected.distance(v));
+			}
+			for (unsigned threads : {1, 3}) {
+				ThreadPool pool(threads);
+				for (double delta : {0.0, 1.0, 4.0, 100.0}) {
+					ShortestPathTree tree = g.deltaStepping(source, pool, delta);
+					for (Vertex v = 0; v < g.getSize(); v++) {
+						REQUIRE(tree.distance(v) == expected.distance(v));
+						if (!tree.reaches(v) || v == source) continue;
+						Vertex parent = tree.parent(v);
+						REQUIRE(tree.distance(parent) + g.getWeight(parent, v) == tree.distance(v));
+					}
+				}
+			}
+		}
+		ShortestPathCache<Graph> cache(g, 1, true);
+		REQUIRE(cache.tree(107)->distance(1912) == g.dijkstra(107).distance(1912));
+	}
+
+	// weights like 0.1 and 0.7 that do not sum exactly: every parent still accounts for its child's distance
+	for (Graph::Edge& e : edges) e.weight = e.weight == 1 ? 0.7 : 0.1 * e.weight;
+	Graph fractional(edges, 4039, false);
+	for (unsigned threads : {1, 3}) {
+		ThreadPool pool(threads);
+		for (double delta : {0.0, 0.3, 2.0}) {
+			ShortestPathTree expected = fractional.dijkstra(107), tree = fractional.deltaStepping(107, pool, delta);
+			for (Vertex v = 0; v < fractional.getSize(); v++) {
+				REQUIRE(tree.reaches(v) == expected.reaches(v));
+				if (!tree.reaches(v)) continue;
+				REQUIRE(tree.distance(v) == Approx(expected.distance(v)));
+				if (v == 107) continue;
+				Vertex parent = tree.parent(v);
+				REQUIRE(parent != ShortestPathTree::NONE);
+				REQUIRE(tree.distance(parent) + fractional.getWeight(parent, v) == tree.distance(v));
+			}
+			for (Vertex v = 0; v < fractional.getSize(); v += 97) {
+				if (tree.reaches(v)) REQUIRE(tree.pathTo(v).front() == 107);
+			}
+		}
+	}
+
+	// skewed weights: unit Edges plus a few huge ones, which make the mean (the default delta) tiny next to
+	// the largest distances, and distance / delta far past what a bucket array could hold
+	for (double huge : {1e15, 1e300}) {
+		vector<Graph::Edge> skewed;
+		for (size_t i = 0; i + 1 < ids.size(); i += 2) skewed.emplace_back(ids[i], ids[i + 1], i % 2000 == 0 ? huge : 1.0);
+		Graph g(skewed, 4039, false);
+		ThreadPool pool(2);
+		for (double delta : {0.0, 1.0, 1e-3}) {
+			ShortestPathTree expected = g.dijkstra(0), tree = g.deltaStepping(0, pool, delta);
+			for (Vertex v = 0; v < g.getSize(); v++) {
+				REQUIRE(tree.reaches(v) == expected.reaches(v));
+				if (tree.reaches(v)) REQUIRE(tree.distance(v) == Approx(expected.distance(v)));
+			}
+		}
+	}
+
+	// unit weights: the same distances as the BFS tree
+	Graph g(ids, false);
+	ThreadPool pool(2);
+	ShortestPathTree bfs = g.shortestPathTree(0), dijkstra = g.dijkstra(0), delta = g.deltaStepping(0, pool);
+	for (Vertex v = 0; v < g.getSize(); v++) {
+		REQUIRE(dijkstra.distance(v) == bfs.distance(v));
+		REQUIRE(delta.distance(v) == bfs.distance(v));
+	}
+
+	// against Floyd-Warshall, with a few weights changed so the fewest Edges is no longer the shortest
+	vector<string> lines = FileReader::fileToVector("tests/test_data_complex_path.txt");
+	for (bool double_directed : {true, false}) {
+		Graph small(lines, double_directed);
+		small.changeWeight(0, 5, 7.5);
+		small.changeWeight(1, 2, 0.25);
+		small.changeWeight(3, 4, 2.5);
+		vector<vector<double>> fw_mat = small.FloydWarshall();
+		for (Vertex source = 0; source < small.getSize(); source++) {
+			ShortestPathTree tree = small.dijkstra(source), parallel = small.deltaStepping(source, pool, 0.5);
+			for (Vertex target = 0; target < small.getSize(); target++) {
+				double expected = fw_mat[source][target] == __INT_MAX__ ? ShortestPathTree::infinity() : fw_mat[source][target];
+				REQUIRE(tree.distance(target) == expected);
+				REQUIRE(parallel.distance(target) == expected);
+				REQUIRE(tree.pathTo(target).empty() == !tree.reaches(target));
+			}
+		}
+		REQUIRE(!small.dijkstra(small.getSize()).reaches(0));
+		REQUIRE(!small.deltaStepping(small.getSize(), pool).reaches(0));
+	}
+}
+
+TEST_CASE("DaryHeap pops in key order", "[dijkstra][heap]") {
+	DaryHeap<> heap;
+	vector<double> keys;
+	// enough entries to grow the array several times
+	for (size_t i = 0; i < 5000; i++) {
+		keys.push_back(double((i * 7919) % 1013));
+		heap.push(keys.back(), i);
+	}
+	std::sort(keys.begin(), keys.end());
+	REQUIRE(heap.size() == keys.size());
+	for (double key : keys) {
+		REQUIRE(heap.top().key == key);
+		REQUIRE(double((heap.top().vertex * 7919) % 1013) == key);
+		heap.pop();
+	}
+	REQUIRE(heap.empty());
+	heap.push(2, 0);
+	heap.push(1, 1);
+	REQUIRE(heap.top().vertex == 1);
+	heap.clear();
+	REQUIRE(heap.empty());
+}